@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+
+#include "atomic.hpp"
+
+namespace embed::cortex_m {
+/**
+ * @brief std::pmr::memory_resource that hands out memory from a fixed arena,
+ * such as a static array placed by the linker.
+ *
+ * Allocation bumps an offset into the arena with a single compare-and-swap,
+ * so it takes constant time and is safe from any interrupt. It is lock-free
+ * on ARMv7-M and above and takes a critical section a few instructions long
+ * on ARMv6-M, see cortex_m::atomic. Memory is only given back when the most
+ * recent allocation is freed, which suits allocations with a stack-like
+ * lifetime. Otherwise it is reclaimed all at once with release(). When the
+ * arena is exhausted, the request is passed to the upstream resource, which by
+ * default is std::pmr::null_memory_resource() and throws std::bad_alloc.
+ *
+ * The arena can be placed in a specific memory, such as core coupled RAM, by
+ * putting it in a section the linker script maps there:
+ *
+ *     [[gnu::section(".ccmram")]] alignas(8) std::array<std::byte, 4096> heap;
+ *     arena_resource arena(heap);
+ *     std::pmr::vector<int> samples(&arena);
+ */
+class arena_resource : public std::pmr::memory_resource
+{
+public:
+  /**
+   * @brief Construct a new arena resource
+   *
+   * @param p_arena - memory to allocate from, must outlive the resource
+   * @param p_upstream - resource to allocate from when the arena is exhausted
+   */
+  explicit arena_resource(
+    std::span<std::byte> p_arena,
+    std::pmr::memory_resource* p_upstream =
+      std::pmr::null_memory_resource()) noexcept
+    : m_arena(p_arena)
+    , m_upstream(p_upstream)
+  {}
+
+  arena_resource(const arena_resource&) = delete;
+  arena_resource& operator=(const arena_resource&) = delete;
+
+  /**
+   * @brief Reclaim every allocation made from the arena at once.
+   *
+   * Must not be called while any of the memory is still in use or while
+   * another context may be allocating.
+   */
+  void release() noexcept { m_used.store(0, std::memory_order_release); }
+
+  /// @return std::size_t - bytes of the arena currently handed out, including
+  /// alignment padding
+  [[nodiscard]] std::size_t used() const noexcept
+  {
+    return m_used.load(std::memory_order_relaxed);
+  }
+
+  /// @return std::size_t - most bytes of the arena that have been in use at
+  /// once
+  [[nodiscard]] std::size_t high_water() const noexcept
+  {
+    return m_high_water.load(std::memory_order_relaxed);
+  }
+
+  /// @return std::size_t - number of allocations that did not fit in the
+  /// arena and were passed upstream
+  [[nodiscard]] std::size_t failures() const noexcept
+  {
+    return m_failures.load(std::memory_order_relaxed);
+  }
+
+  /// @return std::size_t - size of the arena in bytes
+  [[nodiscard]] std::size_t capacity() const noexcept
+  {
+    return m_arena.size();
+  }
+
+private:
+  void* do_allocate(std::size_t p_bytes, std::size_t p_alignment) override
+  {
+    const auto base = reinterpret_cast<std::uintptr_t>(m_arena.data());
+    auto used = m_used.load(std::memory_order_relaxed);
+    std::size_t start = 0;
+    std::size_t end = 0;
+
+    do {
+      const auto address = base + used;
+      const auto aligned = (address + p_alignment - 1) & ~(p_alignment - 1);
+      start = used + (aligned - address);
+      end = start + p_bytes;
+      if (end > m_arena.size() || end < start) {
+        m_failures.fetch_add(1, std::memory_order_relaxed);
+        return m_upstream->allocate(p_bytes, p_alignment);
+      }
+    } while (!m_used.compare_exchange_weak(used,
+                                           end,
+                                           std::memory_order_relaxed,
+                                           std::memory_order_relaxed));
+
+    auto high_water = m_high_water.load(std::memory_order_relaxed);
+    while (end > high_water &&
+           !m_high_water.compare_exchange_weak(high_water,
+                                               end,
+                                               std::memory_order_relaxed,
+                                               std::memory_order_relaxed)) {
+    }
+    return m_arena.data() + start;
+  }
+
+  void do_deallocate(void* p_pointer,
+                     std::size_t p_bytes,
+                     std::size_t p_alignment) override
+  {
+    auto* byte = static_cast<std::byte*>(p_pointer);
+    if (byte < m_arena.data() || byte >= m_arena.data() + m_arena.size()) {
+      m_upstream->deallocate(p_pointer, p_bytes, p_alignment);
+      return;
+    }
+
+    // Only the most recent allocation can be given back. The alignment
+    // padding in front of it stays used until release().
+    const auto start = static_cast<std::size_t>(byte - m_arena.data());
+    auto expected = start + p_bytes;
+    m_used.compare_exchange_strong(expected,
+                                   start,
+                                   std::memory_order_relaxed,
+                                   std::memory_order_relaxed);
+  }
+
+  bool do_is_equal(
+    const std::pmr::memory_resource& p_other) const noexcept override
+  {
+    return this == &p_other;
+  }
+
+  std::span<std::byte> m_arena;
+  std::pmr::memory_resource* m_upstream;
+  atomic<std::size_t> m_used{ 0 };
+  atomic<std::size_t> m_high_water{ 0 };
+  atomic<std::size_t> m_failures{ 0 };
+};
+}  // namespace embed::cortex_m
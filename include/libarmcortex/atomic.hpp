@@ -0,0 +1,267 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+#include "critical_section.hpp"
+
+namespace embed::cortex_m {
+/**
+ * @brief Determines if the target core has the LDREX/STREX exclusive monitor.
+ *
+ * ARMv6-M (Cortex M0, M0+ and M1) does not, every other Cortex M profile and
+ * every host machine used for testing does.
+ */
+#if defined(__ARM_ARCH_6M__)
+inline constexpr bool has_exclusive_monitor = false;
+#else
+inline constexpr bool has_exclusive_monitor = true;
+#endif
+
+/**
+ * @brief Atomic integer or pointer that is lock-free on every Cortex M core.
+ *
+ * `std::atomic` read-modify-write operations do not lower to instructions on
+ * ARMv6-M, as it lacks LDREX/STREX, and instead become calls into libatomic
+ * which is usually unavailable on bare metal targets. This type selects its
+ * implementation at compile time:
+ *
+ * - With an exclusive monitor (ARMv7-M and above), operations use the GCC
+ *   atomic builtins, which lower directly to LDREX/STREX retry loops.
+ * - Without one (ARMv6-M), loads and stores are single aligned accesses, which
+ *   are already atomic, and read-modify-write operations are performed within
+ *   a critical_section spanning only the load, modify and store instructions.
+ *
+ * Code written against this type is portable across both architectures
+ * without any runtime checks.
+ *
+ * @tparam T - integral or pointer type no larger than a machine word
+ * @tparam ExclusiveMonitor - selects the implementation, defaults to the one
+ * appropriate for the target. Only intended to be overridden by tests.
+ */
+template<typename T, bool ExclusiveMonitor = has_exclusive_monitor>
+class atomic
+{
+public:
+  static_assert(std::is_integral_v<T> || std::is_pointer_v<T>,
+                "cortex_m::atomic only supports integral and pointer types");
+  static_assert(sizeof(T) <= sizeof(std::uintptr_t),
+                "cortex_m::atomic only supports types up to a machine word");
+
+  /// Type used for the argument of fetch_add() and fetch_sub()
+  using difference_type =
+    std::conditional_t<std::is_pointer_v<T>, std::ptrdiff_t, T>;
+
+  /**
+   * @brief Construct a new atomic object
+   *
+   * @param p_value - initial value
+   */
+  constexpr atomic(T p_value = T{}) noexcept
+    : m_value(p_value)
+  {}
+
+  atomic(const atomic&) = delete;
+  atomic& operator=(const atomic&) = delete;
+
+  /**
+   * @param p_order - memory ordering of the load
+   * @return T - current value
+   */
+  [[nodiscard]] T load(
+    std::memory_order p_order = std::memory_order_seq_cst) const noexcept
+  {
+    return __atomic_load_n(&m_value, to_int(p_order));
+  }
+
+  /**
+   * @param p_value - value to store
+   * @param p_order - memory ordering of the store
+   */
+  void store(T p_value,
+             std::memory_order p_order = std::memory_order_seq_cst) noexcept
+  {
+    __atomic_store_n(&m_value, p_value, to_int(p_order));
+  }
+
+  /**
+   * @param p_value - value to store
+   * @param p_order - memory ordering of the operation
+   * @return T - value held before the exchange
+   */
+  T exchange(T p_value,
+             std::memory_order p_order = std::memory_order_seq_cst) noexcept
+  {
+    if constexpr (ExclusiveMonitor) {
+      return __atomic_exchange_n(&m_value, p_value, to_int(p_order));
+    } else {
+      return read_modify_write([p_value](T) { return p_value; });
+    }
+  }
+
+  /**
+   * @brief Replace the value with p_desired if it is equal to p_expected.
+   *
+   * May fail spuriously (for example, if an interrupt clears the exclusive
+   * monitor), so it should be used within a retry loop.
+   *
+   * @param p_expected - expected value, updated with the current value on
+   * failure
+   * @param p_desired - value to store on success
+   * @param p_success - memory ordering on success
+   * @param p_failure - memory ordering on failure
+   * @return true - the value was replaced
+   * @return false - the value did not match p_expected
+   */
+  bool compare_exchange_weak(
+    T& p_expected,
+    T p_desired,
+    std::memory_order p_success = std::memory_order_seq_cst,
+    std::memory_order p_failure = std::memory_order_seq_cst) noexcept
+  {
+    return compare_exchange(p_expected, p_desired, true, p_success, p_failure);
+  }
+
+  /**
+   * @brief Replace the value with p_desired if it is equal to p_expected.
+   *
+   * Never fails spuriously.
+   *
+   * @param p_expected - expected value, updated with the current value on
+   * failure
+   * @param p_desired - value to store on success
+   * @param p_success - memory ordering on success
+   * @param p_failure - memory ordering on failure
+   * @return true - the value was replaced
+   * @return false - the value did not match p_expected
+   */
+  bool compare_exchange_strong(
+    T& p_expected,
+    T p_desired,
+    std::memory_order p_success = std::memory_order_seq_cst,
+    std::memory_order p_failure = std::memory_order_seq_cst) noexcept
+  {
+    return compare_exchange(p_expected, p_desired, false, p_success, p_failure);
+  }
+
+  /**
+   * @param p_value - amount to add
+   * @param p_order - memory ordering of the operation
+   * @return T - value held before the addition
+   */
+  T fetch_add(difference_type p_value,
+              std::memory_order p_order = std::memory_order_seq_cst) noexcept
+  {
+    if constexpr (ExclusiveMonitor) {
+      return __atomic_fetch_add(&m_value, scale(p_value), to_int(p_order));
+    } else {
+      return read_modify_write(
+        [p_value](T p_old) { return static_cast<T>(p_old + p_value); });
+    }
+  }
+
+  /**
+   * @param p_value - amount to subtract
+   * @param p_order - memory ordering of the operation
+   * @return T - value held before the subtraction
+   */
+  T fetch_sub(difference_type p_value,
+              std::memory_order p_order = std::memory_order_seq_cst) noexcept
+  {
+    if constexpr (ExclusiveMonitor) {
+      return __atomic_fetch_sub(&m_value, scale(p_value), to_int(p_order));
+    } else {
+      return read_modify_write(
+        [p_value](T p_old) { return static_cast<T>(p_old - p_value); });
+    }
+  }
+
+  /**
+   * @param p_value - mask to bitwise AND with
+   * @param p_order - memory ordering of the operation
+   * @return T - value held before the operation
+   */
+  T fetch_and(T p_value,
+              std::memory_order p_order = std::memory_order_seq_cst) noexcept
+    requires std::is_integral_v<T>
+  {
+    if constexpr (ExclusiveMonitor) {
+      return __atomic_fetch_and(&m_value, p_value, to_int(p_order));
+    } else {
+      return read_modify_write(
+        [p_value](T p_old) { return static_cast<T>(p_old & p_value); });
+    }
+  }
+
+  /**
+   * @param p_value - mask to bitwise OR with
+   * @param p_order - memory ordering of the operation
+   * @return T - value held before the operation
+   */
+  T fetch_or(T p_value,
+             std::memory_order p_order = std::memory_order_seq_cst) noexcept
+    requires std::is_integral_v<T>
+  {
+    if constexpr (ExclusiveMonitor) {
+      return __atomic_fetch_or(&m_value, p_value, to_int(p_order));
+    } else {
+      return read_modify_write(
+        [p_value](T p_old) { return static_cast<T>(p_old | p_value); });
+    }
+  }
+
+private:
+  static constexpr int to_int(std::memory_order p_order) noexcept
+  {
+    return static_cast<int>(p_order);
+  }
+
+  /// The atomic builtins do not scale pointer arithmetic by the element size
+  static constexpr auto scale(difference_type p_value) noexcept
+  {
+    if constexpr (std::is_pointer_v<T>) {
+      return p_value *
+             static_cast<std::ptrdiff_t>(sizeof(std::remove_pointer_t<T>));
+    } else {
+      return p_value;
+    }
+  }
+
+  bool compare_exchange(T& p_expected,
+                        T p_desired,
+                        bool p_weak,
+                        std::memory_order p_success,
+                        std::memory_order p_failure) noexcept
+  {
+    if constexpr (ExclusiveMonitor) {
+      return __atomic_compare_exchange_n(&m_value,
+                                         &p_expected,
+                                         p_desired,
+                                         p_weak,
+                                         to_int(p_success),
+                                         to_int(p_failure));
+    } else {
+      critical_section section;
+      const auto current = __atomic_load_n(&m_value, __ATOMIC_RELAXED);
+      if (current != p_expected) {
+        p_expected = current;
+        return false;
+      }
+      __atomic_store_n(&m_value, p_desired, __ATOMIC_RELAXED);
+      return true;
+    }
+  }
+
+  template<typename Operation>
+  T read_modify_write(Operation p_operation) noexcept
+  {
+    critical_section section;
+    const auto previous = __atomic_load_n(&m_value, __ATOMIC_RELAXED);
+    __atomic_store_n(&m_value, p_operation(previous), __ATOMIC_RELAXED);
+    return previous;
+  }
+
+  alignas(sizeof(T)) T m_value;
+};
+}  // namespace embed::cortex_m
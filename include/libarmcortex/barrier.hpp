@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+
+#include <libembeddedhal/config.hpp>
+
+namespace embed::cortex_m {
+/**
+ * @brief Data memory barrier (DMB).
+ *
+ * Orders explicit memory accesses before the barrier ahead of those after it,
+ * as observed by other bus masters (DMA, other cores).
+ */
+inline void data_memory_barrier() noexcept
+{
+  if constexpr (embed::is_a_test()) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  } else {
+    asm volatile("dmb" ::: "memory");
+  }
+}
+
+/**
+ * @brief Data synchronization barrier (DSB).
+ *
+ * Completes every explicit memory access before the barrier before any
+ * instruction after it executes. Needed after writing to system registers such
+ * as the NVIC so the write has taken effect before continuing.
+ */
+inline void data_synchronization_barrier() noexcept
+{
+  if constexpr (embed::is_a_test()) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  } else {
+    asm volatile("dsb" ::: "memory");
+  }
+}
+
+/**
+ * @brief Instruction synchronization barrier (ISB).
+ *
+ * Flushes the pipeline so that instructions after the barrier are fetched
+ * after the effects of earlier instructions, such as a change to the interrupt
+ * mask or enable state, are visible.
+ */
+inline void instruction_synchronization_barrier() noexcept
+{
+  if constexpr (embed::is_a_test()) {
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+  } else {
+    asm volatile("isb" ::: "memory");
+  }
+}
+}  // namespace embed::cortex_m
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "atomic.hpp"
+
+namespace embed::cortex_m {
+/**
+ * @brief Fixed block pool allocator that can be used from any interrupt.
+ *
+ * Allocating and freeing take constant time and never touch the global heap.
+ * Free blocks are kept on a stack whose head packs a 16-bit block index with a
+ * 16-bit tag into one word. Every update of the head goes through a single
+ * compare-and-swap and increments the tag. If a handler preempts between the
+ * load and the swap, and takes and returns the same block, the tag has still
+ * changed and the swap retries. On ARMv7-M and above the compare-and-swap is
+ * an LDREX/STREX loop, so the pool is lock-free. On ARMv6-M it is a critical
+ * section a few instructions long, see cortex_m::atomic.
+ *
+ * Blocks that have never been allocated are handed out in order by a bump
+ * index once the free list is empty, so the pool needs no initialization and
+ * can be a constant-initialized global.
+ *
+ *     static block_pool<64, 32> packet_pool;
+ *     void* packet = packet_pool.allocate();  // nullptr when exhausted
+ *     packet_pool.deallocate(packet);
+ *
+ * @tparam BlockSize - size of each block in bytes
+ * @tparam BlockCount - number of blocks, less than 65535
+ * @tparam Alignment - alignment of each block, a power of two
+ */
+template<std::size_t BlockSize,
+         std::size_t BlockCount,
+         std::size_t Alignment = alignof(std::max_align_t)>
+class block_pool
+{
+public:
+  static_assert(BlockSize > 0, "block_pool BlockSize must be greater than 0");
+  static_assert(BlockCount > 0 && BlockCount < 0xFFFF,
+                "block_pool BlockCount must fit within a 16-bit index");
+  static_assert((Alignment & (Alignment - 1)) == 0,
+                "block_pool Alignment must be a power of two");
+
+  /// Size of each block after padding it to the alignment
+  static constexpr std::size_t block_stride =
+    (BlockSize + Alignment - 1) / Alignment * Alignment;
+
+  constexpr block_pool() noexcept = default;
+
+  block_pool(const block_pool&) = delete;
+  block_pool& operator=(const block_pool&) = delete;
+
+  /**
+   * @brief Take a block from the pool. Safe to call from any context.
+   *
+   * @return void* - a block of at least BlockSize bytes, or nullptr if every
+   * block is in use
+   */
+  [[nodiscard]] void* allocate() noexcept
+  {
+    auto index = pop();
+    if (index == empty) {
+      index = bump();
+    }
+    if (index == empty) {
+      m_failures.fetch_add(1, std::memory_order_relaxed);
+      return nullptr;
+    }
+
+    const auto in_use = m_in_use.fetch_add(1, std::memory_order_relaxed) + 1;
+    auto high_water = m_high_water.load(std::memory_order_relaxed);
+    while (in_use > high_water &&
+           !m_high_water.compare_exchange_weak(high_water,
+                                               in_use,
+                                               std::memory_order_relaxed,
+                                               std::memory_order_relaxed)) {
+    }
+    return &m_storage[index * block_stride];
+  }
+
+  /**
+   * @brief Return a block to the pool. Safe to call from any context.
+   *
+   * @param p_block - block returned by allocate() of this pool, or nullptr,
+   * which is ignored
+   */
+  void deallocate(void* p_block) noexcept
+  {
+    if (p_block == nullptr) {
+      return;
+    }
+    const auto offset = static_cast<std::size_t>(
+      static_cast<std::byte*>(p_block) - m_storage.data());
+    push(static_cast<std::uint16_t>(offset / block_stride));
+    m_in_use.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * @param p_pointer - any pointer
+   * @return true - p_pointer points into this pool's storage
+   */
+  [[nodiscard]] bool owns(const void* p_pointer) const noexcept
+  {
+    const auto* byte = static_cast<const std::byte*>(p_pointer);
+    return byte >= m_storage.data() &&
+           byte < m_storage.data() + m_storage.size();
+  }
+
+  /// @return std::size_t - number of blocks currently allocated
+  [[nodiscard]] std::size_t in_use() const noexcept
+  {
+    return m_in_use.load(std::memory_order_relaxed);
+  }
+
+  /// @return std::size_t - most blocks that have been allocated at once
+  [[nodiscard]] std::size_t high_water() const noexcept
+  {
+    return m_high_water.load(std::memory_order_relaxed);
+  }
+
+  /// @return std::size_t - number of allocations that found the pool empty
+  [[nodiscard]] std::size_t failures() const noexcept
+  {
+    return m_failures.load(std::memory_order_relaxed);
+  }
+
+  /// @return constexpr std::size_t - number of blocks in the pool
+  [[nodiscard]] static constexpr std::size_t capacity() noexcept
+  {
+    return BlockCount;
+  }
+
+private:
+  static constexpr std::uint16_t empty = 0xFFFF;
+
+  static constexpr std::uint32_t pack(std::uint16_t p_index,
+                                      std::uint32_t p_tag) noexcept
+  {
+    return (p_tag << 16U) | p_index;
+  }
+
+  static constexpr std::uint16_t index_of(std::uint32_t p_head) noexcept
+  {
+    return static_cast<std::uint16_t>(p_head & 0xFFFFU);
+  }
+
+  static constexpr std::uint32_t next_tag(std::uint32_t p_head) noexcept
+  {
+    return (p_head >> 16U) + 1U;
+  }
+
+  std::uint16_t pop() noexcept
+  {
+    auto head = m_head.load(std::memory_order_acquire);
+    while (index_of(head) != empty) {
+      // Reading a stale link when the block was taken in between is harmless,
+      // the tag has changed so the swap fails and the loop reloads it.
+      const auto next = m_next[index_of(head)].load(std::memory_order_relaxed);
+      if (m_head.compare_exchange_weak(head,
+                                       pack(next, next_tag(head)),
+                                       std::memory_order_acquire,
+                                       std::memory_order_acquire)) {
+        return index_of(head);
+      }
+    }
+    return empty;
+  }
+
+  void push(std::uint16_t p_index) noexcept
+  {
+    auto head = m_head.load(std::memory_order_relaxed);
+    do {
+      m_next[p_index].store(index_of(head), std::memory_order_relaxed);
+    } while (!m_head.compare_exchange_weak(head,
+                                           pack(p_index, next_tag(head)),
+                                           std::memory_order_release,
+                                           std::memory_order_relaxed));
+  }
+
+  std::uint16_t bump() noexcept
+  {
+    auto unused = m_unused.load(std::memory_order_relaxed);
+    while (unused < BlockCount) {
+      if (m_unused.compare_exchange_weak(unused,
+                                         static_cast<std::uint16_t>(unused + 1),
+                                         std::memory_order_relaxed,
+                                         std::memory_order_relaxed)) {
+        return unused;
+      }
+    }
+    return empty;
+  }
+
+  alignas(Alignment)
+    std::array<std::byte, block_stride * BlockCount> m_storage{};
+  std::array<atomic<std::uint16_t>, BlockCount> m_next{};
+  atomic<std::uint32_t> m_head{ pack(empty, 0) };
+  atomic<std::uint16_t> m_unused{ 0 };
+  atomic<std::uint32_t> m_in_use{ 0 };
+  atomic<std::uint32_t> m_high_water{ 0 };
+  atomic<std::uint32_t> m_failures{ 0 };
+};
+}  // namespace embed::cortex_m
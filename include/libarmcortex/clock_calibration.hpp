@@ -0,0 +1,199 @@
+#pragma once
+
+#include <cstdint>
+
+#include <libembeddedhal/config.hpp>
+#include <libembeddedhal/error.hpp>
+#include <libembeddedhal/frequency.hpp>
+#include <libxbitset/bitset.hpp>
+
+#include "dwt_counter.hpp"
+#include "systick_timer.hpp"
+
+namespace embed::cortex_m {
+/**
+ * @brief Measures the real CPU frequency against SysTick's external reference
+ * clock, to catch misconfigured clock trees before they skew every timer.
+ *
+ * The SysTick calibration register (CALIB) holds TENMS, the reload value that
+ * gives a 10ms period on the reference clock, which means the reference clock
+ * runs at (TENMS + 1) * 100Hz. measure() runs SysTick from the reference clock
+ * with that reload value and counts DWT cycles across a number of reloads to
+ * find the CPU frequency. calibrate() then feeds the result back into
+ * systick_timer and dwt_counter through register_cpu_frequency().
+ *
+ * The measurement is only as accurate as the reference clock. Vendors set the
+ * SKEW bit when TENMS is not exactly 10ms, and the result reports it so the
+ * caller can decide whether to trust the measurement. Devices without a
+ * reference clock set the NOREF bit and cannot be calibrated this way.
+ */
+class clock_calibration
+{
+public:
+  /// Bit masks of the SysTick calibration register
+  struct calib_register
+  {
+    /// Reload value for a 10ms period on the reference clock, 0 if unknown
+    static constexpr auto tenms = xstd::bitrange::from<0, 23>();
+    /// Set when TENMS is not exactly 10ms because of clock frequency
+    static constexpr auto skew = xstd::bitrange::from<30>();
+    /// Set when the device does not provide a reference clock
+    static constexpr auto noref = xstd::bitrange::from<31>();
+  };
+
+  /// Error indicating that CALIB reports no usable reference clock
+  struct no_reference_clock
+  {
+    /// Contents of the calibration register
+    std::uint32_t calib;
+  };
+
+  /// Outcome of a measurement
+  struct result_t
+  {
+    /// Measured CPU frequency
+    frequency cpu;
+    /// Frequency of the SysTick reference clock according to TENMS
+    frequency reference;
+    /// CALIB reported that TENMS is not exactly 10ms, so the measurement is
+    /// skewed by the same error
+    bool skewed;
+  };
+
+  /**
+   * @brief Decode the reference clock frequency from a CALIB register value
+   *
+   * @param p_calib - contents of the calibration register
+   * @return boost::leaf::result<frequency> - reference clock frequency or
+   * no_reference_clock if NOREF is set or TENMS is 0
+   */
+  static boost::leaf::result<frequency> reference_frequency(
+    std::uint32_t p_calib)
+  {
+    auto calib = xstd::bitmanip(p_calib);
+    const auto tenms = calib.extract<calib_register::tenms>();
+    if (calib.test(calib_register::noref) || tenms == 0) {
+      return boost::leaf::new_error(no_reference_clock{ .calib = p_calib });
+    }
+    return frequency((tenms + 1) * 100U);
+  }
+
+  /**
+   * @brief Compute a clock's frequency from the number of its cycles counted
+   * across a number of cycles of a reference clock.
+   *
+   * @param p_cycles - cycles of the clock being measured
+   * @param p_reference_cycles - cycles of the reference clock in the same time
+   * @param p_reference - frequency of the reference clock
+   * @return frequency - frequency of the measured clock, rounded to the
+   * nearest Hz
+   */
+  static constexpr frequency cross_count(std::uint64_t p_cycles,
+                                         std::uint64_t p_reference_cycles,
+                                         frequency p_reference)
+  {
+    if (p_reference_cycles == 0) {
+      return frequency(0);
+    }
+    const auto scaled = p_cycles * p_reference.cycles_per_second;
+    return frequency(static_cast<std::uint32_t>(
+      (scaled + p_reference_cycles / 2) / p_reference_cycles));
+  }
+
+  /**
+   * @brief Measure the CPU frequency against the SysTick reference clock.
+   *
+   * Busy waits for p_periods + 1 periods of 10ms, during which SysTick is
+   * reprogrammed. SysTick's previous configuration is restored afterwards, but
+   * any scheduled callback will not run during the measurement. The DWT cycle
+   * counter must be running, and the measurement must fit within its 32-bit
+   * range (p_periods * 10ms at the CPU frequency).
+   *
+   * @param p_periods - number of 10ms periods to count over
+   * @return boost::leaf::result<result_t> - the measurement or
+   * no_reference_clock
+   */
+  static boost::leaf::result<result_t> measure(std::uint32_t p_periods = 10)
+  {
+    auto* sys_tick = systick_timer::sys_tick();
+    std::uint32_t calib = sys_tick->calib;
+    const auto reference = BOOST_LEAF_CHECK(reference_frequency(calib));
+    const auto tenms =
+      xstd::bitmanip(calib).extract<calib_register::tenms>();
+    const bool skewed = xstd::bitmanip(calib).test(calib_register::skew);
+
+    const std::uint32_t saved_control = sys_tick->control;
+    const std::uint32_t saved_reload = sys_tick->reload;
+
+    // Run from the reference clock without interrupts, reloading every 10ms
+    sys_tick->control = 0;
+    sys_tick->reload = tenms;
+    sys_tick->current_value = 0;
+    xstd::bitmanip(sys_tick->control)
+      .set(systick_timer::control_register::enable_counter);
+
+    // Align to a reload, then count cycles across the requested periods
+    wait_for_reload();
+    const std::uint32_t start = dwt_counter::dwt()->cyccnt;
+    for (std::uint32_t i = 0; i < p_periods; i++) {
+      wait_for_reload();
+    }
+    const std::uint32_t cycles = dwt_counter::dwt()->cyccnt - start;
+
+    sys_tick->control = 0;
+    sys_tick->reload = saved_reload;
+    sys_tick->current_value = 0;
+    sys_tick->control = saved_control;
+
+    const std::uint64_t reference_cycles =
+      std::uint64_t{ p_periods } * (tenms + 1);
+
+    return result_t{
+      .cpu = cross_count(cycles, reference_cycles, reference),
+      .reference = reference,
+      .skewed = skewed,
+    };
+  }
+
+  /**
+   * @brief Measure the CPU frequency and register it with the timer drivers.
+   *
+   * An event scheduled on the systick_timer is preserved, see
+   * systick_timer::register_cpu_frequency().
+   *
+   * @param p_systick - SysTick driver to update, clocked by the processor
+   * @param p_dwt - DWT counter driver to update
+   * @param p_periods - number of 10ms periods to count over
+   * @return boost::leaf::result<result_t> - the measurement, or
+   * no_reference_clock, or out_of_bounds if the event scheduled on p_systick
+   * does not fit in SysTick at the measured frequency
+   */
+  static boost::leaf::result<result_t> calibrate(systick_timer& p_systick,
+                                                 dwt_counter& p_dwt,
+                                                 std::uint32_t p_periods = 10)
+  {
+    const auto measured = BOOST_LEAF_CHECK(measure(p_periods));
+    BOOST_LEAF_CHECK(p_systick.register_cpu_frequency(measured.cpu));
+    p_dwt.register_cpu_frequency(measured.cpu);
+    return measured;
+  }
+
+private:
+  static void wait_for_reload()
+  {
+    using control_register = systick_timer::control_register;
+    auto* sys_tick = systick_timer::sys_tick();
+    // Reading the control register clears COUNTFLAG on hardware, so read it
+    // once per iteration rather than modifying it in place
+    while (true) {
+      std::uint32_t control = sys_tick->control;
+      if (xstd::bitmanip(control).test(control_register::count_flag)) {
+        break;
+      }
+    }
+    if constexpr (embed::is_a_test()) {
+      xstd::bitmanip(sys_tick->control).reset(control_register::count_flag);
+    }
+  }
+};
+}  // namespace embed::cortex_m
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Applications can override the defaults below either by defining the macros
+// on the command line or by providing a `libarmcortex.tweaks.hpp` header on
+// the include path that defines them.
+#if __has_include(<libarmcortex.tweaks.hpp>)
+#include <libarmcortex.tweaks.hpp>
+#endif
+
+#if !defined(LIBARMCORTEX_ENABLE_TRACE)
+#define LIBARMCORTEX_ENABLE_TRACE 0
+#endif
+
+#if !defined(LIBARMCORTEX_TRACE_CAPACITY)
+#define LIBARMCORTEX_TRACE_CAPACITY 256
+#endif
+
+#if !defined(LIBARMCORTEX_ZERO_LATENCY_THRESHOLD)
+#define LIBARMCORTEX_ZERO_LATENCY_THRESHOLD 0
+#endif
+
+#if !defined(LIBARMCORTEX_DATA_CACHE)
+#define LIBARMCORTEX_DATA_CACHE 0
+#endif
+
+namespace embed::cortex_m::config {
+/// Record interrupt and timer callback events in the global trace buffer
+constexpr bool trace = LIBARMCORTEX_ENABLE_TRACE;
+/// Number of events held by the global trace buffer, a power of two
+constexpr std::size_t trace_capacity = LIBARMCORTEX_TRACE_CAPACITY;
+/// Priority value written to BASEPRI by critical sections. Interrupts with a
+/// lower priority value are zero latency and are never masked by the library.
+/// 0 masks every interrupt with PRIMASK instead.
+constexpr std::uint8_t zero_latency_threshold =
+  LIBARMCORTEX_ZERO_LATENCY_THRESHOLD;
+/// The core has a data cache (Cortex M7) that must be maintained around DMA.
+/// Cache maintenance compiles to nothing when false.
+constexpr bool data_cache = LIBARMCORTEX_DATA_CACHE;
+}  // namespace embed::cortex_m::config
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "csv_writer.hpp"
+#include "cycle_cost.hpp"
+#include "system_control.hpp"
+
+namespace embed::cortex_m {
+/// Core configuration options compared by benchmark_configuration()
+enum class core_knob : std::uint8_t
+{
+  /// system_control::core_configuration::data_cache
+  data_cache,
+  /// system_control::core_configuration::instruction_cache
+  instruction_cache,
+  /// system_control::core_configuration::branch_prediction
+  branch_prediction,
+  /// system_control::core_configuration::disable_write_buffer
+  write_buffer,
+  /// system_control::core_configuration::disable_it_folding
+  it_folding,
+  /// system_control::core_configuration::disable_multicycle_interrupt
+  multicycle_interrupt,
+};
+
+/// Number of core_knob values
+inline constexpr std::size_t core_knob_count = 6;
+
+/**
+ * @param p_knob - configuration option
+ * @return const char* - name of the option
+ */
+constexpr const char* to_string(core_knob p_knob)
+{
+  switch (p_knob) {
+    case core_knob::data_cache:
+      return "data_cache";
+    case core_knob::instruction_cache:
+      return "instruction_cache";
+    case core_knob::branch_prediction:
+      return "branch_prediction";
+    case core_knob::write_buffer:
+      return "write_buffer";
+    case core_knob::it_folding:
+      return "it_folding";
+    case core_knob::multicycle_interrupt:
+      return "multicycle_interrupt";
+  }
+  return "unknown";
+}
+
+/// Effect of toggling one configuration option on the kernel
+struct knob_result
+{
+  /// Option toggled from the configuration in place when benchmarking
+  core_knob knob;
+  /// The core implements the option and the toggle took effect
+  bool applied;
+  /// Fewest cycles the kernel took with the configuration in place
+  std::uint32_t baseline;
+  /// Fewest cycles the kernel took with the option toggled
+  std::uint32_t cycles;
+};
+
+/**
+ * @brief Reference kernel for benchmark_configuration().
+ *
+ * Mixes the work the options affect: a loop over an array in RAM (data cache,
+ * branch prediction), data dependent conditionals that compile to IT blocks
+ * (IT folding), back to back stores (write buffer) and a multiply accumulate.
+ */
+[[gnu::noinline]] inline void reference_kernel()
+{
+  static std::array<std::uint32_t, 256> samples{};
+  static volatile std::uint32_t sink = 0;
+
+  std::uint32_t accumulator = sink;
+  for (std::size_t i = 0; i < samples.size(); i++) {
+    auto value = samples[i] + static_cast<std::uint32_t>(i);
+    value = (value & 1U) != 0 ? value * 3U : value >> 1U;
+    accumulator += value * 7U;
+    samples[i] = value;
+  }
+  sink = accumulator;
+}
+
+/**
+ * @brief Measure the kernel with each core_knob toggled in turn from the
+ * current configuration.
+ *
+ * Each measurement is the fewest DWT cycles the kernel took over p_samples
+ * runs, after one run to warm up the caches. The current configuration is
+ * restored afterwards. The DWT cycle counter must have been started by
+ * constructing a dwt_counter.
+ *
+ * @param p_results - where to write the results, core_knob_count long is
+ * always enough
+ * @param p_kernel - code to measure
+ * @param p_samples - number of runs per measurement
+ * @return std::size_t - number of results written
+ */
+inline std::size_t benchmark_configuration(
+  std::span<knob_result> p_results,
+  void (*p_kernel)() = reference_kernel,
+  std::size_t p_samples = 8)
+{
+  auto measure = [p_kernel, p_samples]() {
+    return fewest_cycles(p_kernel, p_samples);
+  };
+
+  system_control control;
+  const auto baseline = control.get_core_configuration();
+  const auto baseline_cycles = measure();
+
+  const auto count = std::min(p_results.size(), core_knob_count);
+  for (std::size_t i = 0; i < count; i++) {
+    const auto knob = static_cast<core_knob>(i);
+    auto toggled = baseline;
+    switch (knob) {
+      case core_knob::data_cache:
+        toggled.data_cache = !toggled.data_cache;
+        break;
+      case core_knob::instruction_cache:
+        toggled.instruction_cache = !toggled.instruction_cache;
+        break;
+      case core_knob::branch_prediction:
+        toggled.branch_prediction = !toggled.branch_prediction;
+        break;
+      case core_knob::write_buffer:
+        toggled.disable_write_buffer = !toggled.disable_write_buffer;
+        break;
+      case core_knob::it_folding:
+        toggled.disable_it_folding = !toggled.disable_it_folding;
+        break;
+      case core_knob::multicycle_interrupt:
+        toggled.disable_multicycle_interrupt =
+          !toggled.disable_multicycle_interrupt;
+        break;
+    }
+
+    const bool applied = control.set_core_configuration(toggled) == toggled;
+    const auto cycles = measure();
+    control.set_core_configuration(baseline);
+
+    p_results[i] = knob_result{ .knob = knob,
+                                .applied = applied,
+                                .baseline = baseline_cycles,
+                                .cycles = cycles };
+  }
+  return count;
+}
+
+/**
+ * @brief Format configuration benchmark results as CSV, a header line and
+ * then one option per line.
+ *
+ * @param p_results - results to format
+ * @param p_buffer - destination, truncated as described by csv_writer
+ * @return std::size_t - number of characters written, excluding the null
+ */
+inline std::size_t write_csv(std::span<const knob_result> p_results,
+                             std::span<char> p_buffer)
+{
+  csv_writer csv(p_buffer);
+  csv.append("knob,applied,baseline,cycles\n");
+  for (const auto& result : p_results) {
+    csv.append("%s,%s,%lu,%lu\n",
+               to_string(result.knob),
+               result.applied ? "yes" : "no",
+               static_cast<unsigned long>(result.baseline),
+               static_cast<unsigned long>(result.cycles));
+  }
+  return csv.size();
+}
+}  // namespace embed::cortex_m
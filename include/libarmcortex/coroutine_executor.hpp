@@ -0,0 +1,446 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <span>
+#include <utility>
+
+#include <libembeddedhal/error.hpp>
+#include <libembeddedhal/timer/interface.hpp>
+
+#include "atomic.hpp"
+#include "interrupt.hpp"
+#include "mpsc_queue.hpp"
+#include "wait_for_event.hpp"
+
+namespace embed::cortex_m {
+/**
+ * @brief Statically allocated executor for C++20 coroutines that suspend on
+ * interrupts and on SysTick driven delays.
+ *
+ * Coroutines return `coroutine_executor::task` and can `co_await`:
+ *
+ *   - `irq_event(irq)` - resumed after the interrupt fires. The interrupt is
+ *     enabled with a shared trampoline when awaited, and the trampoline masks
+ *     it again in the NVIC after waking the coroutine, so the coroutine can
+ *     service the peripheral in thread context before awaiting it again.
+ *   - `sleep_for(duration)` - resumed after at least `duration` has elapsed,
+ *     measured in ticks of the timer given to start_ticks().
+ *
+ * Interrupts and ticks never run coroutine bodies. They only move the
+ * coroutine to a lock-free ready queue, and the thread calling run() or
+ * run_once() resumes it. This keeps ISRs short and deterministic and means
+ * coroutine bodies never run in interrupt context.
+ *
+ * Coroutine frames are allocated from a fixed arena statically allocated by
+ * initialize(), so nothing touches the heap. If a frame does not fit in a
+ * block, or all blocks are in use, creating the task yields an empty task that
+ * spawn() rejects.
+ *
+ * Tasks must be created, spawned and run from a single thread.
+ */
+class coroutine_executor
+{
+public:
+  /// Maximum number of coroutines that can be suspended on events at once
+  static constexpr std::size_t max_tasks = 32;
+
+  /**
+   * @brief Fire-and-forget coroutine type scheduled by the executor.
+   *
+   */
+  class task
+  {
+  public:
+    /// Coroutine promise, allocates frames from the executor's arena
+    struct promise_type
+    {
+      /// @return task - owning handle to the newly created coroutine
+      task get_return_object() noexcept
+      {
+        return task(std::coroutine_handle<promise_type>::from_promise(*this));
+      }
+      /// @return task - empty task used when the arena is exhausted
+      static task get_return_object_on_allocation_failure() noexcept
+      {
+        return task();
+      }
+      /// @return std::suspend_always - tasks only run once spawned
+      std::suspend_always initial_suspend() noexcept { return {}; }
+      /// @return std::suspend_never - frames are released on completion
+      std::suspend_never final_suspend() noexcept { return {}; }
+      /// Tasks do not produce a value
+      void return_void() noexcept {}
+      /// Exceptions escaping a task are unrecoverable
+      void unhandled_exception() noexcept { std::abort(); }
+
+      /**
+       * @param p_size - size of the coroutine frame
+       * @return void* - block from the arena or nullptr if none are available
+       */
+      static void* operator new(std::size_t p_size) noexcept
+      {
+        return allocate_frame(p_size);
+      }
+
+      /**
+       * @param p_frame - frame to return to the arena
+       */
+      static void operator delete(void* p_frame) noexcept
+      {
+        free_frame(p_frame);
+      }
+    };
+
+    /// Construct an empty task
+    task() noexcept = default;
+
+    task(const task&) = delete;
+    task& operator=(const task&) = delete;
+
+    /**
+     * @brief Take ownership of another task's coroutine
+     *
+     * @param p_other - task to move from
+     */
+    task(task&& p_other) noexcept
+      : m_handle(std::exchange(p_other.m_handle, nullptr))
+    {}
+
+    /**
+     * @brief Destroy a task that was never spawned
+     */
+    ~task()
+    {
+      if (m_handle) {
+        m_handle.destroy();
+      }
+    }
+
+    /// @return true - if the task holds a coroutine
+    explicit operator bool() const noexcept { return bool(m_handle); }
+
+  private:
+    friend class coroutine_executor;
+
+    explicit task(std::coroutine_handle<promise_type> p_handle) noexcept
+      : m_handle(p_handle)
+    {}
+
+    std::coroutine_handle<promise_type> m_handle = nullptr;
+  };
+
+  /**
+   * @brief Awaitable that suspends the coroutine until an interrupt fires.
+   *
+   * Resumes with true once the interrupt has fired, or immediately with false
+   * if the IRQ is invalid or too many coroutines are already waiting.
+   */
+  class irq_event
+  {
+  public:
+    /**
+     * @param p_irq - interrupt request number to wait on
+     */
+    explicit irq_event(int p_irq) noexcept
+      : m_irq(p_irq)
+    {}
+
+    /// @return false - always suspends
+    bool await_ready() const noexcept { return false; }
+
+    /**
+     * @param p_handle - coroutine to resume when the interrupt fires
+     * @return true - suspended until the interrupt fires
+     * @return false - could not wait on the interrupt, resume immediately
+     */
+    bool await_suspend(std::coroutine_handle<> p_handle) noexcept
+    {
+      for (auto& waiter : m_irq_waiters) {
+        if (waiter.handle.load(std::memory_order_relaxed) != nullptr) {
+          continue;
+        }
+        waiter.irq.store(m_irq, std::memory_order_relaxed);
+        waiter.handle.store(p_handle.address(), std::memory_order_release);
+        if (!interrupt(m_irq).enable(irq_trampoline)) {
+          waiter.handle.store(nullptr, std::memory_order_relaxed);
+          return false;
+        }
+        m_waiting = true;
+        return true;
+      }
+      return false;
+    }
+
+    /// @return true - if the interrupt fired
+    bool await_resume() const noexcept { return m_waiting; }
+
+  private:
+    int m_irq;
+    bool m_waiting = false;
+  };
+
+  /**
+   * @brief Awaitable that suspends the coroutine for at least a duration.
+   *
+   * Resumes with true once the duration has elapsed, or immediately with false
+   * if ticks have not been started or too many coroutines are already
+   * sleeping.
+   */
+  class sleep_for
+  {
+  public:
+    /**
+     * @param p_duration - minimum time to sleep for
+     */
+    explicit sleep_for(std::chrono::nanoseconds p_duration) noexcept
+      : m_duration(p_duration)
+    {}
+
+    /// @return false - always suspends
+    bool await_ready() const noexcept { return false; }
+
+    /**
+     * @param p_handle - coroutine to resume when the time has elapsed
+     * @return true - suspended until the deadline
+     * @return false - could not sleep, resume immediately
+     */
+    bool await_suspend(std::coroutine_handle<> p_handle) noexcept
+    {
+      if (m_tick_period.count() <= 0) {
+        return false;
+      }
+
+      // Round up so that the sleep is never shorter than requested, and add a
+      // tick because the current tick period has already partially elapsed.
+      const auto rounded_up =
+        (m_duration + m_tick_period - std::chrono::nanoseconds(1)) /
+        m_tick_period;
+      const auto ticks = rounded_up + 1;
+      const auto deadline = m_ticks.load(std::memory_order_relaxed) +
+                            static_cast<std::uint32_t>(ticks);
+
+      for (auto& sleeper : m_sleepers) {
+        if (sleeper.handle.load(std::memory_order_relaxed) != nullptr) {
+          continue;
+        }
+        sleeper.deadline.store(deadline, std::memory_order_relaxed);
+        sleeper.handle.store(p_handle.address(), std::memory_order_release);
+        m_sleeping = true;
+        return true;
+      }
+      return false;
+    }
+
+    /// @return true - if the full duration elapsed
+    bool await_resume() const noexcept { return m_sleeping; }
+
+  private:
+    std::chrono::nanoseconds m_duration;
+    bool m_sleeping = false;
+  };
+
+  /**
+   * @brief Statically allocate the arena that coroutine frames are taken from.
+   *
+   * Like interrupt::initialize(), only the first call has any effect.
+   *
+   * @tparam FrameCount - number of coroutine frames that can exist at once
+   * @tparam FrameSize - size in bytes of each frame block
+   */
+  template<std::size_t FrameCount, std::size_t FrameSize = 256>
+  static void initialize()
+  {
+    static_assert(FrameCount <= max_tasks,
+                  "The ready queue can only hold up to max_tasks coroutines");
+    static constexpr auto block_size =
+      (FrameSize + alignof(std::max_align_t) - 1) &
+      ~(alignof(std::max_align_t) - 1);
+    alignas(std::max_align_t) static std::array<std::byte,
+                                                block_size * FrameCount>
+      arena{};
+
+    if (m_arena.empty()) {
+      m_arena = arena;
+      m_frame_size = block_size;
+      for (std::size_t i = 0; i < FrameCount; i++) {
+        free_frame(&arena[i * block_size]);
+      }
+    }
+  }
+
+  /**
+   * @brief Start the tick source used by sleep_for().
+   *
+   * Schedules tick() on the timer. The SysTick timer keeps counting with the
+   * same reload value after firing, so its callback repeats every period.
+   *
+   * @param p_timer - timer driving the ticks, typically systick_timer
+   * @param p_period - time between ticks
+   * @return boost::leaf::result<void> - any error from scheduling the timer
+   */
+  static boost::leaf::result<void> start_ticks(
+    embed::timer& p_timer,
+    std::chrono::nanoseconds p_period)
+  {
+    BOOST_LEAF_CHECK(p_timer.schedule(tick, p_period));
+    m_tick_period = p_period;
+    return {};
+  }
+
+  /**
+   * @brief Hand a task over to the executor, which will start it on the next
+   * call to run_once().
+   *
+   * @param p_task - task to run
+   * @return true - the task was scheduled
+   * @return false - the task is empty (its frame could not be allocated)
+   */
+  static bool spawn(task p_task) noexcept
+  {
+    if (!p_task) {
+      return false;
+    }
+    const auto handle = std::exchange(p_task.m_handle, nullptr);
+    schedule(handle.address());
+    return true;
+  }
+
+  /**
+   * @brief Resume a single coroutine that is ready to run, if any.
+   *
+   * @return true - a coroutine was resumed
+   * @return false - no coroutines were ready
+   */
+  static bool run_once() noexcept
+  {
+    auto address = m_ready.pop();
+    if (!address) {
+      return false;
+    }
+    std::coroutine_handle<>::from_address(*address).resume();
+    return true;
+  }
+
+  /**
+   * @brief Run coroutines forever, sleeping in WFE when none are ready.
+   *
+   */
+  [[noreturn]] static void run() noexcept
+  {
+    while (true) {
+      if (!run_once()) {
+        wait_for_event();
+      }
+    }
+  }
+
+  /**
+   * @brief Advance the tick count and make ready any sleepers whose deadline
+   * has passed. Installed as the timer callback by start_ticks().
+   *
+   * Takes time proportional to max_tasks.
+   */
+  static void tick() noexcept
+  {
+    const auto now = m_ticks.fetch_add(1, std::memory_order_relaxed) + 1;
+    for (auto& sleeper : m_sleepers) {
+      auto* address = sleeper.handle.load(std::memory_order_acquire);
+      if (address == nullptr) {
+        continue;
+      }
+      const auto remaining = static_cast<std::int32_t>(
+        sleeper.deadline.load(std::memory_order_relaxed) - now);
+      if (remaining <= 0) {
+        sleeper.handle.store(nullptr, std::memory_order_relaxed);
+        schedule(address);
+      }
+    }
+  }
+
+  /**
+   * @brief Shared interrupt handler used by irq_event.
+   *
+   * Determines the active IRQ, makes its waiter ready and masks the IRQ in the
+   * NVIC so it cannot fire again until the coroutine awaits it again.
+   */
+  static void irq_trampoline() noexcept
+  {
+    const auto irq = interrupt::active_irq();
+    for (auto& waiter : m_irq_waiters) {
+      auto* address = waiter.handle.load(std::memory_order_acquire);
+      if (address == nullptr ||
+          waiter.irq.load(std::memory_order_relaxed) != irq) {
+        continue;
+      }
+      waiter.handle.store(nullptr, std::memory_order_relaxed);
+      schedule(address);
+    }
+    (void)interrupt(irq).disable();
+  }
+
+  /// @return std::size_t - number of free coroutine frame blocks
+  static std::size_t frames_available() noexcept
+  {
+    std::size_t count = 0;
+    for (auto* block = m_free_frames; block != nullptr; block = block->next) {
+      count++;
+    }
+    return count;
+  }
+
+private:
+  struct free_frame_t
+  {
+    free_frame_t* next;
+  };
+
+  struct irq_waiter_t
+  {
+    atomic<int> irq;
+    atomic<void*> handle;
+  };
+
+  struct sleeper_t
+  {
+    atomic<std::uint32_t> deadline;
+    atomic<void*> handle;
+  };
+
+  static void* allocate_frame(std::size_t p_size) noexcept
+  {
+    if (p_size > m_frame_size || m_free_frames == nullptr) {
+      return nullptr;
+    }
+    return std::exchange(m_free_frames, m_free_frames->next);
+  }
+
+  static void free_frame(void* p_frame) noexcept
+  {
+    auto* block = static_cast<free_frame_t*>(p_frame);
+    block->next = m_free_frames;
+    m_free_frames = block;
+  }
+
+  static void schedule(void* p_address) noexcept
+  {
+    // Cannot fail, every suspended coroutine occupies at most one entry and
+    // there can be no more coroutines than max_tasks.
+    (void)m_ready.push(p_address);
+    send_event();
+  }
+
+  static inline std::span<std::byte> m_arena{};
+  static inline std::size_t m_frame_size = 0;
+  static inline free_frame_t* m_free_frames = nullptr;
+  static inline mpsc_queue<void*, max_tasks> m_ready{};
+  static inline std::array<irq_waiter_t, max_tasks> m_irq_waiters{};
+  static inline std::array<sleeper_t, max_tasks> m_sleepers{};
+  static inline atomic<std::uint32_t> m_ticks{ 0 };
+  static inline std::chrono::nanoseconds m_tick_period{ 0 };
+};
+}  // namespace embed::cortex_m
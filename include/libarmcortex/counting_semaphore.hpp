@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+
+#include "atomic.hpp"
+#include "wait_for_event.hpp"
+
+namespace embed::cortex_m {
+/**
+ * @brief Counting semaphore that interrupt service routines release and that
+ * threads acquire while sleeping in WFE.
+ *
+ * Releasing is lock-free and safe from any interrupt. Acquirers sleep with WFE
+ * rather than spinning on a volatile variable, and are woken by the SEV issued
+ * by release().
+ */
+class counting_semaphore
+{
+public:
+  /**
+   * @brief Construct a new counting semaphore object
+   *
+   * @param p_initial_count - number of permits initially available
+   */
+  explicit counting_semaphore(std::uint32_t p_initial_count = 0) noexcept
+    : m_count(p_initial_count)
+  {}
+
+  /**
+   * @brief Add permits and wake any waiters. Safe to call from an ISR.
+   *
+   * @param p_permits - number of permits to add
+   */
+  void release(std::uint32_t p_permits = 1) noexcept
+  {
+    m_count.fetch_add(p_permits, std::memory_order_release);
+    send_event();
+  }
+
+  /**
+   * @brief Take a permit if one is available, without waiting.
+   *
+   * @return true - a permit was taken
+   * @return false - no permits were available
+   */
+  [[nodiscard]] bool try_acquire() noexcept
+  {
+    auto count = m_count.load(std::memory_order_relaxed);
+    while (count != 0U) {
+      if (m_count.compare_exchange_weak(count,
+                                        count - 1,
+                                        std::memory_order_acquire,
+                                        std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Sleep until a permit is available and take it.
+   *
+   */
+  void acquire() noexcept
+  {
+    wait_for_event_until([this]() { return try_acquire(); });
+  }
+
+  /**
+   * @brief Sleep until a permit is available and take it, giving up after a
+   * timeout.
+   *
+   * See wait_for_event_until() for the timeout resolution.
+   *
+   * @param p_timeout_cycles - maximum number of CPU cycles to wait
+   * @return true - a permit was taken
+   * @return false - the timeout elapsed
+   */
+  [[nodiscard]] bool try_acquire_for(std::uint32_t p_timeout_cycles) noexcept
+  {
+    return wait_for_event_until([this]() { return try_acquire(); },
+                                p_timeout_cycles);
+  }
+
+  /// @return std::uint32_t - number of permits available at the time of call
+  [[nodiscard]] std::uint32_t available() const noexcept
+  {
+    return m_count.load(std::memory_order_relaxed);
+  }
+
+private:
+  atomic<std::uint32_t> m_count;
+};
+}  // namespace embed::cortex_m
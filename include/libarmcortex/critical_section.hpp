@@ -0,0 +1,167 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+
+#include <libembeddedhal/config.hpp>
+
+#include "config.hpp"
+
+namespace embed::cortex_m {
+/**
+ * @brief Determines if the target core has the BASEPRI register.
+ *
+ * ARMv6-M (Cortex M0, M0+ and M1) does not and can only mask interrupts all
+ * at once with PRIMASK.
+ */
+#if defined(__ARM_ARCH_6M__)
+inline constexpr bool has_basepri = false;
+#else
+inline constexpr bool has_basepri = true;
+#endif
+
+/**
+ * @brief RAII guard that masks interrupts for the duration of its lifetime.
+ *
+ * By default every configurable priority interrupt is masked using PRIMASK.
+ * When config::zero_latency_threshold is set, BASEPRI is raised to that
+ * threshold instead, so interrupts with a lower priority value (zero latency
+ * interrupts, see interrupt::basic_zero_latency) are never delayed by the
+ * library. The previous mask state is saved on construction and restored on
+ * destruction, so critical sections can be nested and can be used from
+ * contexts that already have interrupts masked.
+ *
+ * This is the fallback used by the library on cores that lack the exclusive
+ * monitor (ARMv6-M). Keep the guarded region to a handful of instructions, as
+ * every masked interrupt on the system is delayed for its duration.
+ *
+ * A critical section cannot exclude a zero latency interrupt, so one must
+ * never be entered from a zero latency handler. When zero latency interrupts
+ * are enabled, doing so aborts.
+ *
+ * When running as a test on a host machine, PRIMASK is emulated with a global
+ * spin lock so that threads standing in for interrupts are excluded from each
+ * other the same way.
+ */
+class critical_section
+{
+public:
+  static_assert(config::zero_latency_threshold == 0 || has_basepri,
+                "Zero latency interrupts need BASEPRI, which ARMv6-M lacks");
+
+  /// Bit within PRIMASK that masks interrupts when set
+  static constexpr std::uint32_t primask_disable = 1U << 0U;
+
+  /// Mask with BASEPRI rather than PRIMASK
+  static constexpr bool uses_basepri = config::zero_latency_threshold != 0;
+
+  /**
+   * @brief Tracks whether a zero latency handler is running, for the check
+   * that critical sections are never entered from one.
+   *
+   * Zero latency handlers preempt everything the library masks, so while one
+   * is active no code that may take a critical section can run except the
+   * handler itself (and any zero latency handler nested in it).
+   */
+  class zero_latency_context
+  {
+  public:
+    /// Mark the start of a zero latency handler
+    static void enter() noexcept
+    {
+      m_depth = m_depth + 1;
+      std::atomic_signal_fence(std::memory_order_seq_cst);
+    }
+
+    /// Mark the end of a zero latency handler
+    static void exit() noexcept
+    {
+      std::atomic_signal_fence(std::memory_order_seq_cst);
+      m_depth = m_depth - 1;
+    }
+
+    /// @return bool - a zero latency handler is running
+    static bool active() noexcept { return m_depth != 0; }
+
+  private:
+    static inline volatile std::uint32_t m_depth = 0;
+  };
+
+  /**
+   * @brief Mask interrupts, saving the previous interrupt mask state.
+   *
+   */
+  critical_section() noexcept
+    : m_mask(disable_interrupts())
+  {}
+
+  critical_section(const critical_section&) = delete;
+  critical_section& operator=(const critical_section&) = delete;
+
+  /**
+   * @brief Restore the interrupt mask state saved on construction.
+   *
+   */
+  ~critical_section() noexcept { restore_interrupts(m_mask); }
+
+private:
+  static std::uint32_t disable_interrupts() noexcept
+  {
+    if constexpr (uses_basepri) {
+      if (zero_latency_context::active()) {
+        std::abort();
+      }
+    }
+
+    if constexpr (embed::is_a_test()) {
+      if (host_depth()++ == 0) {
+        while (host_lock().test_and_set(std::memory_order_acquire)) {
+        }
+      }
+      return 0;
+    } else if constexpr (uses_basepri) {
+      // BASEPRI_MAX only ever raises the masking level, so a nested section
+      // never unmasks anything masked by an outer one.
+      std::uint32_t basepri = 0;
+      asm volatile("mrs %0, basepri" : "=r"(basepri)::"memory");
+      asm volatile("msr basepri_max, %0" ::"r"(
+                     std::uint32_t{ config::zero_latency_threshold })
+                   : "memory");
+      return basepri;
+    } else {
+      std::uint32_t primask = 0;
+      asm volatile("mrs %0, primask" : "=r"(primask)::"memory");
+      asm volatile("cpsid i" ::: "memory");
+      return primask;
+    }
+  }
+
+  static void restore_interrupts(std::uint32_t p_mask) noexcept
+  {
+    if constexpr (embed::is_a_test()) {
+      if (--host_depth() == 0) {
+        host_lock().clear(std::memory_order_release);
+      }
+    } else if constexpr (uses_basepri) {
+      asm volatile("msr basepri, %0" ::"r"(p_mask) : "memory");
+    } else {
+      asm volatile("msr primask, %0" ::"r"(p_mask) : "memory");
+    }
+  }
+
+  static std::atomic_flag& host_lock() noexcept
+  {
+    static std::atomic_flag lock = ATOMIC_FLAG_INIT;
+    return lock;
+  }
+
+  static int& host_depth() noexcept
+  {
+    static thread_local int depth = 0;
+    return depth;
+  }
+
+  std::uint32_t m_mask;
+};
+}  // namespace embed::cortex_m
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdio>
+#include <span>
+
+namespace embed::cortex_m {
+/**
+ * @brief Formats lines of text into a fixed buffer, such as benchmark results
+ * as CSV to print over a serial port.
+ *
+ * The output is truncated to fit and is always null terminated.
+ *
+ *     csv_writer csv(buffer);
+ *     csv.append("name,cycles\n");
+ *     csv.append("%s,%lu\n", name, static_cast<unsigned long>(cycles));
+ *     uart.write(std::span(buffer.data(), csv.size()));
+ */
+class csv_writer
+{
+public:
+  /**
+   * @brief Construct a new csv writer object
+   *
+   * @param p_buffer - destination, must outlive the writer
+   */
+  explicit csv_writer(std::span<char> p_buffer) noexcept
+    : m_buffer(p_buffer)
+  {
+    if (!m_buffer.empty()) {
+      m_buffer[0] = '\0';
+    }
+  }
+
+  /**
+   * @brief Append printf style formatted text
+   *
+   * @param p_format - format string
+   * @param ... - arguments to format
+   */
+  [[gnu::format(printf, 2, 3)]] void append(const char* p_format, ...) noexcept
+  {
+    if (m_buffer.empty()) {
+      return;
+    }
+
+    std::va_list arguments;
+    va_start(arguments, p_format);
+    const int written = std::vsnprintf(m_buffer.data() + m_length,
+                                       m_buffer.size() - m_length,
+                                       p_format,
+                                       arguments);
+    va_end(arguments);
+
+    if (written > 0) {
+      m_length = std::min(m_length + static_cast<std::size_t>(written),
+                          m_buffer.size() - 1);
+    }
+  }
+
+  /// @return std::size_t - number of characters written, excluding the null
+  [[nodiscard]] std::size_t size() const noexcept { return m_length; }
+
+private:
+  std::span<char> m_buffer;
+  std::size_t m_length = 0;
+};
+}  // namespace embed::cortex_m
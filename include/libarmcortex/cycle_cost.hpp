@@ -0,0 +1,146 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+#include "csv_writer.hpp"
+#include "dwt_counter.hpp"
+
+namespace embed::cortex_m {
+/// Cost of one operation measured by a benchmark
+struct operation_cost
+{
+  /// Name of the operation, such as "spsc_queue::push"
+  const char* operation;
+  /// Fewest cycles the operation took
+  std::uint32_t cycles;
+};
+
+/**
+ * @brief Collects benchmark results into a caller supplied span, dropping
+ * those that do not fit.
+ *
+ * @tparam Result - type of a single result
+ */
+template<typename Result>
+class result_recorder
+{
+public:
+  /**
+   * @brief Construct a new result recorder object
+   *
+   * @param p_results - where to write the results
+   */
+  explicit result_recorder(std::span<Result> p_results) noexcept
+    : m_results(p_results)
+  {}
+
+  /**
+   * @brief Append a result if there is room for it
+   *
+   * @param p_result - result to append
+   */
+  void record(const Result& p_result) noexcept
+  {
+    if (m_count < m_results.size()) {
+      m_results[m_count++] = p_result;
+    }
+  }
+
+  /// @return std::size_t - number of results written
+  [[nodiscard]] std::size_t size() const noexcept { return m_count; }
+
+private:
+  std::span<Result> m_results;
+  std::size_t m_count = 0;
+};
+
+/// Collects operation costs, see result_recorder
+class cost_recorder : public result_recorder<operation_cost>
+{
+public:
+  using result_recorder::record;
+  using result_recorder::result_recorder;
+
+  /**
+   * @brief Append the cost of an operation if there is room for it
+   *
+   * @param p_operation - name of the operation
+   * @param p_cycles - fewest cycles the operation took
+   */
+  void record(const char* p_operation, std::uint32_t p_cycles) noexcept
+  {
+    record({ .operation = p_operation, .cycles = p_cycles });
+  }
+};
+
+/**
+ * @brief Measure the fewest DWT cycles code takes over p_samples runs, after
+ * one run to warm up the caches.
+ *
+ * p_prepare runs before every run, outside of the measurement, to put the
+ * state back where the code expects it, such as emptying a queue before
+ * measuring a push. The DWT cycle counter must have been started by
+ * constructing a dwt_counter.
+ *
+ * @param p_code - code to measure
+ * @param p_prepare - code to run before each run of p_code, not measured
+ * @param p_samples - number of measured runs
+ * @return std::uint32_t - fewest cycles p_code took
+ */
+template<std::invocable Code, std::invocable Prepare>
+std::uint32_t fewest_cycles(Code&& p_code,
+                            Prepare&& p_prepare,
+                            std::size_t p_samples = 8)
+{
+  p_prepare();
+  p_code();
+  std::uint32_t fewest = std::numeric_limits<std::uint32_t>::max();
+  for (std::size_t i = 0; i < p_samples; i++) {
+    p_prepare();
+    const std::uint32_t start = dwt_counter::dwt()->cyccnt;
+    p_code();
+    fewest = std::min(fewest, dwt_counter::dwt()->cyccnt - start);
+  }
+  return fewest;
+}
+
+/**
+ * @brief Measure the fewest DWT cycles code takes over p_samples runs, after
+ * one run to warm up the caches.
+ *
+ * @param p_code - code to measure
+ * @param p_samples - number of measured runs
+ * @return std::uint32_t - fewest cycles p_code took
+ */
+template<std::invocable Code>
+std::uint32_t fewest_cycles(Code&& p_code, std::size_t p_samples = 8)
+{
+  return fewest_cycles(p_code, []() {}, p_samples);
+}
+
+/**
+ * @brief Format operation costs as CSV, a header line and then one operation
+ * per line.
+ *
+ * @param p_results - results to format
+ * @param p_buffer - destination, truncated as described by csv_writer
+ * @return std::size_t - number of characters written, excluding the null
+ */
+inline std::size_t write_csv(std::span<const operation_cost> p_results,
+                             std::span<char> p_buffer)
+{
+  csv_writer csv(p_buffer);
+  csv.append("operation,cycles\n");
+  for (const auto& result : p_results) {
+    csv.append("%s,%lu\n",
+               result.operation,
+               static_cast<unsigned long>(result.cycles));
+  }
+  return csv.size();
+}
+}  // namespace embed::cortex_m
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+
+#include <libembeddedhal/error.hpp>
+#include <libembeddedhal/timer/interface.hpp>
+
+#include "interrupt.hpp"
+
+namespace embed::cortex_m {
+/**
+ * @brief A strictly periodic task of a cyclic_executive
+ *
+ * @tparam Run - function run on each release of the task
+ * @tparam PeriodUs - time between releases in microseconds
+ * @tparam OffsetUs - time of the first release in microseconds, must be less
+ * than the period
+ * @tparam WcetUs - worst case execution time budget in microseconds
+ */
+template<interrupt_pointer Run,
+         std::uint32_t PeriodUs,
+         std::uint32_t OffsetUs = 0,
+         std::uint32_t WcetUs = 0>
+struct periodic_task
+{
+  static_assert(PeriodUs > 0, "Task period must be greater than zero");
+  static_assert(OffsetUs < PeriodUs,
+                "Task offset must be less than its period");
+
+  /// Function run on each release
+  static constexpr interrupt_pointer run = Run;
+  /// Time between releases in microseconds
+  static constexpr std::uint32_t period = PeriodUs;
+  /// Time of the first release in microseconds
+  static constexpr std::uint32_t offset = OffsetUs;
+  /// Worst case execution time budget in microseconds
+  static constexpr std::uint32_t wcet = WcetUs;
+};
+
+/**
+ * @brief Time-triggered cyclic executive with a schedule table built at
+ * compile time.
+ *
+ * The frame (minor cycle) is the greatest common divisor of every period and
+ * offset, so every release falls on a frame boundary. The hyperperiod (major
+ * cycle) is the least common multiple of the periods. For each frame of the
+ * hyperperiod, the table holds a bitmask of the tasks released in it. A
+ * static_assert fails the build if the WCET budgets of the tasks in any frame
+ * add up to more than the frame, so an overloaded schedule can never ship.
+ *
+ * At runtime a timer calls tick() once per frame, and tick() looks up the
+ * frame's bitmask and runs its tasks in the order they were declared. Each
+ * tick does a constant amount of work, independent of the hyperperiod.
+ *
+ * Usage:
+ *
+ *     using schedule = cyclic_executive<
+ *       periodic_task<read_sensors, 1'000, 0, 200>,
+ *       periodic_task<control_loop, 2'000, 0, 400>,
+ *       periodic_task<telemetry, 10'000, 500, 300>>;
+ *
+ *     systick_timer timer(cpu_frequency);
+ *     schedule::start(timer);
+ *
+ * @tparam Tasks - periodic_task types, at most 32, in priority order
+ */
+template<typename... Tasks>
+class cyclic_executive
+{
+public:
+  static_assert(sizeof...(Tasks) > 0, "A schedule needs at least one task");
+  static_assert(sizeof...(Tasks) <= 32, "A schedule can hold at most 32 tasks");
+
+  /// Bitmask of the tasks released in a frame, bit N is the Nth task
+  using frame_mask = std::uint32_t;
+
+  /// Length of a frame in microseconds
+  static constexpr std::uint32_t frame_us = []() {
+    std::uint32_t divisor = 0;
+    ((divisor = std::gcd(divisor, std::gcd(Tasks::period, Tasks::offset))),
+     ...);
+    return divisor;
+  }();
+
+  /// Length of the hyperperiod in microseconds
+  static constexpr std::uint64_t hyperperiod_us = []() {
+    std::uint64_t multiple = 1;
+    ((multiple = std::lcm(multiple, std::uint64_t{ Tasks::period })), ...);
+    return multiple;
+  }();
+
+  /// Number of frames in the hyperperiod, and entries in the table
+  static constexpr std::size_t frame_count =
+    static_cast<std::size_t>(hyperperiod_us / frame_us);
+
+  static_assert(frame_count <= 4096,
+                "Schedule table is too large, choose periods with a smaller "
+                "hyperperiod or a larger common divisor");
+
+  /// Tasks released in each frame of the hyperperiod
+  static constexpr std::array<frame_mask, frame_count> frames = []() {
+    std::array<frame_mask, frame_count> table{};
+    auto release = [&table](std::uint64_t p_offset,
+                            std::uint64_t p_period,
+                            frame_mask p_bit) {
+      for (auto time = p_offset; time < hyperperiod_us; time += p_period) {
+        table[static_cast<std::size_t>(time / frame_us)] |= p_bit;
+      }
+    };
+    std::uint32_t index = 0;
+    (release(Tasks::offset, Tasks::period, 1U << index++), ...);
+    return table;
+  }();
+
+  /// Sum of the WCET budgets of the tasks released in each frame
+  static constexpr std::array<std::uint32_t, frame_count> frame_load_us = []() {
+    std::array<std::uint32_t, frame_count> load{};
+    for (std::size_t frame = 0; frame < frame_count; frame++) {
+      std::size_t index = 0;
+      ((load[frame] += ((frames[frame] >> index++) & 1U) ? Tasks::wcet : 0U),
+       ...);
+    }
+    return load;
+  }();
+
+  static_assert(
+    []() {
+      for (auto load : frame_load_us) {
+        if (load > frame_us) {
+          return false;
+        }
+      }
+      return true;
+    }(),
+    "Schedule is overloaded: the WCET of the tasks released in a frame exceed "
+    "the frame length");
+
+  /**
+   * @brief Start executing the schedule from the first frame.
+   *
+   * @param p_timer - periodic timer, such as systick_timer, that will call
+   * tick() every frame
+   * @return boost::leaf::result<void> - errors from scheduling the timer
+   */
+  static boost::leaf::result<void> start(embed::timer& p_timer)
+  {
+    m_frame = 0;
+    return p_timer.schedule(tick, std::chrono::microseconds(frame_us));
+  }
+
+  /**
+   * @brief Run the tasks of the current frame and advance to the next one.
+   *
+   * Called by the timer started with start(). Can also be called directly by
+   * an interrupt that occurs every frame_us.
+   */
+  static void tick()
+  {
+    const auto mask = frames[m_frame];
+    run(mask, std::index_sequence_for<Tasks...>{});
+    m_frame = (m_frame + 1 == frame_count) ? 0 : m_frame + 1;
+  }
+
+  /// @return std::size_t - index of the frame the next tick() will run
+  static std::size_t current_frame() { return m_frame; }
+
+private:
+  template<std::size_t... Index>
+  static void run(frame_mask p_mask, std::index_sequence<Index...>)
+  {
+    ((((p_mask >> Index) & 1U) != 0U ? Tasks::run() : void()), ...);
+  }
+
+  static inline std::size_t m_frame = 0;
+};
+}  // namespace embed::cortex_m
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+#include "atomic.hpp"
+#include "dwt_counter.hpp"
+#include "mpsc_queue.hpp"
+
+/**
+ * @brief Log a message to a deferred_log without formatting it on the target.
+ *
+ * The format string is placed in the `libarmcortex_log` section and only its
+ * address, the DWT cycle count and the raw arguments are written to the log.
+ * To keep the format strings out of flash entirely, place the section in the
+ * linker script as a non-loaded section:
+ *
+ *     libarmcortex_log 0 (INFO) : { KEEP(*(libarmcortex_log)) }
+ *
+ * and extract it for the host side decoder with:
+ *
+ *     arm-none-eabi-objcopy -O binary --only-section=libarmcortex_log \
+ *       firmware.elf log_strings.bin
+ *
+ * Supported conversions are those of printf, with every integer up to 32-bits
+ * and every floating point value taking a single word. 64-bit integers take
+ * two words and must use the `ll` length modifier. `%s` is only supported for
+ * strings that are themselves interned, see LIBARMCORTEX_LOG_STRING.
+ *
+ * @param p_log - deferred_log to write to
+ * @param p_format - printf style string literal
+ */
+#define LIBARMCORTEX_LOG(p_log, p_format, ...)                                 \
+  do {                                                                         \
+    [[gnu::section("libarmcortex_log"), gnu::used]] static const char          \
+      libarmcortex_log_format[] = p_format;                                    \
+    (void)(p_log).write(libarmcortex_log_format __VA_OPT__(, ) __VA_ARGS__);  \
+  } while (0)
+
+/**
+ * @brief Intern a string literal in the `libarmcortex_log` section so that it
+ * can be passed as a `%s` argument to LIBARMCORTEX_LOG.
+ *
+ * @param p_string - string literal
+ */
+#define LIBARMCORTEX_LOG_STRING(p_string)                                      \
+  ([]() {                                                                      \
+    [[gnu::section("libarmcortex_log"), gnu::used]] static const char          \
+      libarmcortex_log_string[] = p_string;                                    \
+    return static_cast<const char*>(libarmcortex_log_string);                  \
+  }())
+
+namespace embed::cortex_m {
+/**
+ * @brief Lock-free binary log that defers all formatting to the host.
+ *
+ * Each record is a sequence of 32-bit words:
+ *
+ *     [marker | argument word count][format id][cycle count][arguments...]
+ *
+ * where the format id is the address of the interned format string. Writing a
+ * record costs a compare-and-swap and a handful of stores, making it cheap
+ * enough for interrupt service routines. Records from any number of ISRs and
+ * threads are written atomically with respect to each other. When the log is
+ * full, new records are dropped and counted rather than overwriting old ones.
+ *
+ * A single consumer drains the raw words with read() and ships them to the
+ * host (UART, RTT, a debugger dump, ...) where deferred_log_decoder, from
+ * deferred_log_decoder.hpp, turns them back into text.
+ *
+ * @tparam Capacity - number of 32-bit words the log can hold, a power of two
+ */
+template<std::size_t Capacity>
+class deferred_log
+{
+public:
+  /// Upper byte of the first word of every record, used to resynchronize
+  static constexpr std::uint32_t record_marker = 0xA5U << 24U;
+  /// Mask of the first word of a record holding the argument word count
+  static constexpr std::uint32_t argument_count_mask = 0xFFU;
+  /// Number of words before the arguments of a record
+  static constexpr std::size_t header_words = 3;
+
+  /**
+   * @brief Write a record. Normally called through LIBARMCORTEX_LOG.
+   *
+   * @param p_format - interned format string
+   * @param p_arguments - integral, floating point, enum or pointer arguments
+   * @return true - the record was written
+   * @return false - the log was full, the record was dropped
+   */
+  template<typename... Arguments>
+  bool write(const char* p_format, Arguments... p_arguments) noexcept
+  {
+    static constexpr std::size_t argument_words =
+      (word_count<Arguments>() + ... + 0);
+    static_assert(argument_words <= argument_count_mask,
+                  "Too many arguments for a single log record");
+
+    std::array<std::uint32_t, header_words + argument_words> record{};
+    record[0] = record_marker | static_cast<std::uint32_t>(argument_words);
+    record[1] = address_of(p_format);
+    record[2] = dwt_counter::dwt()->cyccnt;
+
+    [[maybe_unused]] std::size_t index = header_words;
+    (encode(record, index, p_arguments), ...);
+
+    if (!m_queue.push_all(record)) {
+      m_dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Drain raw words from the log. Must only be called by one consumer.
+   *
+   * May return part of a record if a writer has been preempted while writing
+   * it; the rest will be returned by a later call.
+   *
+   * @param p_destination - buffer to copy words into
+   * @return std::size_t - number of words copied
+   */
+  [[nodiscard]] std::size_t read(
+    std::span<std::uint32_t> p_destination) noexcept
+  {
+    return m_queue.pop(p_destination);
+  }
+
+  /// @return std::uint32_t - number of records dropped because the log was full
+  [[nodiscard]] std::uint32_t dropped() const noexcept
+  {
+    return m_dropped.load(std::memory_order_relaxed);
+  }
+
+private:
+  template<typename T>
+  static constexpr std::size_t word_count()
+  {
+    static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T> ||
+                    std::is_pointer_v<T> || std::is_null_pointer_v<T>,
+                  "Log arguments must be arithmetic, enum or pointer types");
+    if constexpr ((std::is_integral_v<T> || std::is_enum_v<T>) &&
+                  sizeof(T) > sizeof(std::uint32_t)) {
+      return 2;
+    } else {
+      return 1;
+    }
+  }
+
+  static std::uint32_t address_of(const void* p_pointer) noexcept
+  {
+    return static_cast<std::uint32_t>(
+      reinterpret_cast<std::uintptr_t>(p_pointer));
+  }
+
+  template<std::size_t Size, typename T>
+  static void encode(std::array<std::uint32_t, Size>& p_record,
+                     std::size_t& p_index,
+                     T p_argument) noexcept
+  {
+    if constexpr (std::is_enum_v<T>) {
+      encode(p_record,
+             p_index,
+             static_cast<std::underlying_type_t<T>>(p_argument));
+    } else if constexpr (std::is_floating_point_v<T>) {
+      p_record[p_index++] =
+        std::bit_cast<std::uint32_t>(static_cast<float>(p_argument));
+    } else if constexpr (std::is_pointer_v<T> || std::is_null_pointer_v<T>) {
+      p_record[p_index++] = address_of(p_argument);
+    } else if constexpr (sizeof(T) > sizeof(std::uint32_t)) {
+      const auto value = static_cast<std::uint64_t>(p_argument);
+      p_record[p_index++] = static_cast<std::uint32_t>(value);
+      p_record[p_index++] = static_cast<std::uint32_t>(value >> 32U);
+    } else if constexpr (std::is_signed_v<T>) {
+      p_record[p_index++] =
+        static_cast<std::uint32_t>(static_cast<std::int32_t>(p_argument));
+    } else {
+      p_record[p_index++] = static_cast<std::uint32_t>(p_argument);
+    }
+  }
+
+  mpsc_queue<std::uint32_t, Capacity> m_queue{};
+  atomic<std::uint32_t> m_dropped{ 0 };
+};
+}  // namespace embed::cortex_m
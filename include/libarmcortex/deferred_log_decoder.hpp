@@ -0,0 +1,190 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "deferred_log.hpp"
+
+namespace embed::cortex_m {
+/**
+ * @brief Host side decoder that reconstructs text from deferred_log records.
+ *
+ * Needs the contents of the `libarmcortex_log` section from the firmware's ELF
+ * along with the address the section was linked at. Allocates and formats
+ * with the standard library, so it is only meant for host tools and not for
+ * firmware, which only needs deferred_log.hpp.
+ */
+class deferred_log_decoder
+{
+public:
+  /// A single decoded log record
+  struct record
+  {
+    /// DWT cycle count when the record was written
+    std::uint32_t cycle_count;
+    /// Formatted text of the record
+    std::string text;
+  };
+
+  /**
+   * @brief Construct a new deferred log decoder object
+   *
+   * @param p_strings - contents of the `libarmcortex_log` section
+   * @param p_address - address the section was linked at
+   */
+  deferred_log_decoder(std::span<const char> p_strings,
+                       std::uint32_t p_address)
+    : m_strings(p_strings)
+    , m_address(p_address)
+  {}
+
+  /**
+   * @brief Decode every complete record at the front of a stream of words.
+   *
+   * Words that do not start a record are skipped so that decoding can resume
+   * after a corrupted or truncated record.
+   *
+   * @param p_words - words read from deferred_log::read()
+   * @param p_output - decoded records are appended here
+   * @return std::size_t - number of words consumed. Any remaining words are an
+   * incomplete record and should be passed again once more words arrive.
+   */
+  std::size_t decode(std::span<const std::uint32_t> p_words,
+                     std::vector<record>& p_output) const
+  {
+    static constexpr auto marker = deferred_log<1>::record_marker;
+    static constexpr auto count_mask = deferred_log<1>::argument_count_mask;
+    static constexpr auto header_words = deferred_log<1>::header_words;
+
+    std::size_t index = 0;
+    while (index < p_words.size()) {
+      if ((p_words[index] & ~count_mask) != marker) {
+        index++;
+        continue;
+      }
+      const auto length = header_words + (p_words[index] & count_mask);
+      if (index + length > p_words.size()) {
+        break;
+      }
+      const auto words = p_words.subspan(index, length);
+      p_output.push_back({
+        .cycle_count = words[2],
+        .text = format(lookup(words[1]), words.subspan(header_words)),
+      });
+      index += length;
+    }
+    return index;
+  }
+
+private:
+  std::string_view lookup(std::uint32_t p_address) const
+  {
+    const auto offset = static_cast<std::uint32_t>(p_address - m_address);
+    if (offset >= m_strings.size()) {
+      return {};
+    }
+    const auto string =
+      std::string_view(m_strings.data(), m_strings.size()).substr(offset);
+    return string.substr(0, string.find('\0'));
+  }
+
+  std::string format(std::string_view p_format,
+                     std::span<const std::uint32_t> p_arguments) const
+  {
+    if (p_format.empty()) {
+      return "<unknown format string>";
+    }
+
+    std::string output;
+    std::size_t argument = 0;
+    auto next_word = [&]() -> std::uint32_t {
+      return argument < p_arguments.size() ? p_arguments[argument++] : 0U;
+    };
+
+    for (std::size_t i = 0; i < p_format.size(); i++) {
+      if (p_format[i] != '%') {
+        output += p_format[i];
+        continue;
+      }
+      if (i + 1 < p_format.size() && p_format[i + 1] == '%') {
+        output += '%';
+        i++;
+        continue;
+      }
+
+      // Collect flags, width and precision, then the length and conversion
+      const auto start = i++;
+      while (i < p_format.size() &&
+             std::string_view("-+ #0123456789.").find(p_format[i]) !=
+               std::string_view::npos) {
+        i++;
+      }
+      const auto prefix = std::string(p_format.substr(start, i - start));
+      bool wide = false;
+      while (i < p_format.size() &&
+             std::string_view("hljztL").find(p_format[i]) !=
+               std::string_view::npos) {
+        wide = wide || p_format[i] == 'j' ||
+               (p_format[i] == 'l' && i + 1 < p_format.size() &&
+                p_format[i + 1] == 'l');
+        i++;
+      }
+      if (i >= p_format.size()) {
+        break;
+      }
+
+      const char conversion = p_format[i];
+      std::array<char, 64> buffer{};
+      const auto spec = prefix + conversion;
+      const auto wide_spec = prefix + "ll" + conversion;
+
+      if (std::string_view("di").find(conversion) != std::string_view::npos) {
+        const auto low = next_word();
+        const auto value =
+          wide ? static_cast<long long>(
+                   (std::uint64_t{ next_word() } << 32U) | low)
+               : static_cast<long long>(static_cast<std::int32_t>(low));
+        std::snprintf(buffer.data(), buffer.size(), wide_spec.c_str(), value);
+      } else if (std::string_view("uoxX").find(conversion) !=
+                 std::string_view::npos) {
+        const auto low = next_word();
+        const auto value =
+          wide ? (std::uint64_t{ next_word() } << 32U) | low
+               : std::uint64_t{ low };
+        std::snprintf(buffer.data(),
+                      buffer.size(),
+                      wide_spec.c_str(),
+                      static_cast<unsigned long long>(value));
+      } else if (std::string_view("fFeEgGaA").find(conversion) !=
+                 std::string_view::npos) {
+        const auto value = std::bit_cast<float>(next_word());
+        std::snprintf(buffer.data(),
+                      buffer.size(),
+                      spec.c_str(),
+                      static_cast<double>(value));
+      } else if (conversion == 'c') {
+        std::snprintf(
+          buffer.data(), buffer.size(), spec.c_str(), int(next_word()));
+      } else if (conversion == 'p') {
+        std::snprintf(buffer.data(), buffer.size(), "0x%08x", next_word());
+      } else if (conversion == 's') {
+        const auto string = lookup(next_word());
+        output += string.empty() ? "<unknown string>" : std::string(string);
+        continue;
+      }
+      output += buffer.data();
+    }
+    return output;
+  }
+
+  std::span<const char> m_strings;
+  std::uint32_t m_address;
+};
+}  // namespace embed::cortex_m
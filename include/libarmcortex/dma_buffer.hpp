@@ -0,0 +1,194 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+#include "barrier.hpp"
+#include "config.hpp"
+#include "system_control.hpp"
+
+namespace embed::cortex_m {
+/**
+ * @brief Cache maintenance through the SCB cache operation registers, for
+ * cores with a data cache (Cortex M7).
+ */
+struct scb_cache_maintenance
+{
+  /// Maintenance is performed
+  static constexpr bool enabled = true;
+
+  /// Write the line back to memory so the device reads what the CPU wrote
+  static void clean(std::uintptr_t p_address) noexcept
+  {
+    system_control::cache()->dccmvac = static_cast<std::uint32_t>(p_address);
+  }
+
+  /// Discard the line so the CPU reads what the device wrote
+  static void invalidate(std::uintptr_t p_address) noexcept
+  {
+    system_control::cache()->dcimvac = static_cast<std::uint32_t>(p_address);
+  }
+
+  /// Write the line back to memory, then discard it
+  static void clean_invalidate(std::uintptr_t p_address) noexcept
+  {
+    system_control::cache()->dccimvac = static_cast<std::uint32_t>(p_address);
+  }
+
+  /// Complete the memory accesses and maintenance issued so far
+  static void synchronize() noexcept
+  {
+    data_synchronization_barrier();
+    instruction_synchronization_barrier();
+  }
+};
+
+/// Cache maintenance for cores without a data cache, does nothing
+struct no_cache_maintenance
+{
+  /// Maintenance is skipped entirely
+  static constexpr bool enabled = false;
+
+  /// Does nothing
+  static void clean(std::uintptr_t) noexcept {}
+  /// Does nothing
+  static void invalidate(std::uintptr_t) noexcept {}
+  /// Does nothing
+  static void clean_invalidate(std::uintptr_t) noexcept {}
+  /// Does nothing
+  static void synchronize() noexcept {}
+};
+
+/// Cache maintenance for the target, see config::data_cache
+using default_cache_maintenance = std::conditional_t<config::data_cache,
+                                                     scb_cache_maintenance,
+                                                     no_cache_maintenance>;
+
+/// How a DMA transfer accesses a buffer
+enum class dma_access : std::uint8_t
+{
+  /// The device reads the buffer, such as a transmit buffer
+  read,
+  /// The device writes the buffer, such as a receive buffer
+  write,
+  /// The device reads and writes the buffer
+  read_write,
+};
+
+/**
+ * @brief Buffer for DMA transfers that shares no cache lines with other data.
+ *
+ * The buffer is aligned to system_control::cache_line_size and padded to a
+ * whole number of lines. Invalidating its lines therefore never discards
+ * writes to neighboring variables. Ownership is handed back and forth
+ * explicitly, and each transition issues only the maintenance the transfer
+ * needs, over only the lines that hold the elements involved:
+ *
+ * | transition  | read  | write      | read_write       |
+ * |-------------|-------|------------|------------------|
+ * | to_device() | clean | invalidate | clean_invalidate |
+ * | to_cpu()    | none  | invalidate | invalidate       |
+ *
+ * Invalidating before a device write keeps a dirty line from being evicted
+ * over the incoming data. Invalidating again afterwards discards lines the
+ * core may have fetched speculatively during the transfer. The CPU must not
+ * touch the buffer while the device owns it. On cores without a data cache
+ * both transitions compile to nothing.
+ *
+ *     dma_buffer<std::uint8_t, 64> rx;
+ *     rx.to_device(dma_access::write);
+ *     start_dma(rx.data().data(), rx.size());
+ *     // ... transfer complete interrupt ...
+ *     rx.to_cpu(dma_access::write, received);
+ *
+ * @tparam T - trivially copyable element type
+ * @tparam N - number of elements
+ * @tparam CacheMaintenance - scb_cache_maintenance, no_cache_maintenance or a
+ * type with the same static members
+ */
+template<typename T,
+         std::size_t N,
+         typename CacheMaintenance = default_cache_maintenance>
+class dma_buffer
+{
+public:
+  static_assert(std::is_trivially_copyable_v<T>,
+                "dma_buffer elements must be trivially copyable");
+  static_assert(N > 0, "dma_buffer must hold at least one element");
+
+  /// Size of a cache line in bytes
+  static constexpr std::size_t line_size = system_control::cache_line_size;
+
+  /**
+   * @brief Hand the buffer to the device before starting a transfer.
+   *
+   * @param p_access - how the transfer accesses the buffer
+   * @param p_count - number of elements, from the start, the transfer uses
+   */
+  void to_device(dma_access p_access, std::size_t p_count = N) noexcept
+  {
+    if constexpr (CacheMaintenance::enabled) {
+      switch (p_access) {
+        case dma_access::read:
+          maintain<CacheMaintenance::clean>(p_count);
+          break;
+        case dma_access::write:
+          maintain<CacheMaintenance::invalidate>(p_count);
+          break;
+        case dma_access::read_write:
+          maintain<CacheMaintenance::clean_invalidate>(p_count);
+          break;
+      }
+    }
+  }
+
+  /**
+   * @brief Take the buffer back from the device after a transfer completes.
+   *
+   * @param p_access - how the transfer accessed the buffer
+   * @param p_count - number of elements, from the start, the device wrote
+   */
+  void to_cpu(dma_access p_access, std::size_t p_count = N) noexcept
+  {
+    if constexpr (CacheMaintenance::enabled) {
+      if (p_access != dma_access::read) {
+        maintain<CacheMaintenance::invalidate>(p_count);
+      }
+    }
+  }
+
+  /// @return std::span<T, N> - the elements, only access while the CPU owns
+  /// the buffer
+  [[nodiscard]] std::span<T, N> data() noexcept { return m_data; }
+
+  /// @return std::span<const T, N> - the elements, only access while the CPU
+  /// owns the buffer
+  [[nodiscard]] std::span<const T, N> data() const noexcept { return m_data; }
+
+  /// @return constexpr std::size_t - size of the elements in bytes
+  [[nodiscard]] static constexpr std::size_t size() noexcept
+  {
+    return sizeof(T) * N;
+  }
+
+private:
+  template<void (*Operation)(std::uintptr_t)>
+  void maintain(std::size_t p_count) noexcept
+  {
+    const auto start = reinterpret_cast<std::uintptr_t>(m_data.data());
+    const auto end = start + sizeof(T) * std::min(p_count, N);
+
+    CacheMaintenance::synchronize();
+    for (auto line = start; line < end; line += line_size) {
+      Operation(line);
+    }
+    CacheMaintenance::synchronize();
+  }
+
+  alignas(line_size) std::array<T, N> m_data{};
+};
+}  // namespace embed::cortex_m
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+
+#include <libembeddedhal/config.hpp>
+#include <libembeddedhal/error.hpp>
+#include <libembeddedhal/static_callable.hpp>
+
+#include "barrier.hpp"
+#include "dwt_counter.hpp"
+#include "interrupt.hpp"
+#include "system_control.hpp"
+
+namespace embed::cortex_m {
+/// Exception entry to user code cycles for each way of installing a handler
+struct dispatch_latency
+{
+  /// Handler installed directly in the vector table
+  std::uint32_t raw;
+  /// Handler wrapped by interrupt::trampoline
+  std::uint32_t trampoline;
+  /// Callback stored in a static_callable, as systick_timer does
+  std::uint32_t static_callable;
+  /// Callback stored in a std::function called from a vector table handler
+  std::uint32_t function;
+  /// Handler behind a source predicate in an interrupt::chain, as used for
+  /// shared interrupt lines
+  std::uint32_t chain;
+};
+
+/**
+ * @brief Measures the cycles from an interrupt being requested to the first
+ * line of user code in its handler.
+ *
+ * Each sample reads the DWT cycle counter immediately before a raw store of
+ * the IRQ to the NVIC's STIR, then waits for the handler to call mark(). The
+ * result includes the store to STIR, exception entry (12 cycles on Cortex
+ * M3/M4 with zero wait state memory) and whatever the dispatch path executes
+ * before user code: prologues, loads of stored callbacks and indirect calls.
+ * The minimum over the samples is reported, which leaves out samples delayed
+ * by other interrupts or by the vector table and handler not being in cache.
+ *
+ * start(), request() and sample() are the building blocks of measure(), for
+ * benchmarks whose span starts somewhere other than a request, such as
+ * latency_benchmark.
+ *
+ * The IRQ must not be used by anything else while measuring, and its handler
+ * is removed afterwards. The DWT cycle counter must have been started by
+ * constructing a dwt_counter.
+ *
+ *     auto latency = entry_latency<spare_irq>::measure_dispatch_styles();
+ *
+ * @tparam Irq - unused device IRQ to measure with
+ */
+template<int Irq>
+class entry_latency
+{
+public:
+  static_assert(Irq >= 0, "Only device IRQs can be requested through STIR");
+
+  /// Call first in the handler being measured, marks the start of user code
+  [[gnu::always_inline]] static void mark() noexcept
+  {
+    m_latency = dwt_counter::dwt()->cyccnt - m_pended_at;
+    m_marked = true;
+  }
+
+  /// Mark the start of the span measured by the next sample
+  [[gnu::always_inline]] static void start() noexcept
+  {
+    m_pended_at = dwt_counter::dwt()->cyccnt;
+  }
+
+  /**
+   * @brief Request an interrupt with a single store to STIR.
+   *
+   * Nothing is checked, so the IRQ must have been validated beforehand, such
+   * as by enabling it. On the host, where there is no NVIC to take the
+   * interrupt, its handler is called through VTOR with ICSR showing it as the
+   * active exception, like the hardware would.
+   *
+   * @param p_irq - device IRQ to request
+   */
+  [[gnu::always_inline]] static void request(int p_irq = Irq) noexcept
+  {
+    interrupt::nvic()->stir = static_cast<std::uint32_t>(p_irq);
+    if constexpr (embed::is_a_test()) {
+      const auto* table =
+        reinterpret_cast<interrupt_pointer*>(system_control::scb()->vtor);
+      const std::uint32_t icsr = system_control::scb()->icsr;
+      system_control::scb()->icsr =
+        static_cast<std::uint32_t>(p_irq + interrupt::core_interrupts);
+      table[p_irq + interrupt::core_interrupts]();
+      system_control::scb()->icsr = icsr;
+    }
+  }
+
+  /**
+   * @brief Take one sample.
+   *
+   * @param p_trigger - calls start() and then causes a handler that calls
+   * mark() to run, such as with request()
+   * @return std::uint32_t - cycles from start() to mark()
+   */
+  template<typename Trigger>
+  static std::uint32_t sample(Trigger p_trigger)
+  {
+    m_marked = false;
+    data_synchronization_barrier();
+    p_trigger();
+    while (!m_marked) {
+      continue;
+    }
+    return m_latency;
+  }
+
+  /**
+   * @brief Measure the entry latency of a handler.
+   *
+   * @param p_handler - handler to install on Irq, must call mark()
+   * @param p_samples - number of times to take the interrupt
+   * @return boost::leaf::result<std::uint32_t> - fewest cycles from the
+   * request to mark() seen, fails with the errors of interrupt::enable()
+   */
+  static boost::leaf::result<std::uint32_t> measure(
+    interrupt_pointer p_handler,
+    std::size_t p_samples = 16)
+  {
+    // Validates Irq once, so each request is a single store
+    BOOST_LEAF_CHECK(interrupt(Irq).enable(p_handler));
+
+    std::uint32_t fewest = std::numeric_limits<std::uint32_t>::max();
+    for (std::size_t i = 0; i < p_samples; i++) {
+      const auto cycles = sample([]() {
+        start();
+        request();
+      });
+      fewest = cycles < fewest ? cycles : fewest;
+    }
+
+    BOOST_LEAF_CHECK(interrupt(Irq).disable());
+    return fewest;
+  }
+
+  /**
+   * @brief Measure the entry latency of a raw handler, an
+   * interrupt::trampoline, a static_callable, a std::function and an
+   * interrupt::chain.
+   *
+   * @param p_samples - number of times to take the interrupt for each style
+   * @return boost::leaf::result<dispatch_latency> - fewest cycles seen for
+   * each style, fails with the errors of interrupt::enable()
+   */
+  static boost::leaf::result<dispatch_latency> measure_dispatch_styles(
+    std::size_t p_samples = 16)
+  {
+    auto callable = static_callable<entry_latency, 0, void(void)>(
+      []() { entry_latency::mark(); });
+    m_function = []() { entry_latency::mark(); };
+
+    const auto raw = BOOST_LEAF_CHECK(measure(raw_handler, p_samples));
+    const auto trampoline = BOOST_LEAF_CHECK(
+      measure(interrupt::trampoline<raw_handler>, p_samples));
+    const auto stored =
+      BOOST_LEAF_CHECK(measure(callable.get_handler(), p_samples));
+    const auto function =
+      BOOST_LEAF_CHECK(measure(function_handler, p_samples));
+    const auto chain = BOOST_LEAF_CHECK(measure(
+      interrupt::chain<interrupt::shared_source<raw_handler, source_fired>>,
+      p_samples));
+
+    return dispatch_latency{
+      .raw = raw,
+      .trampoline = trampoline,
+      .static_callable = stored,
+      .function = function,
+      .chain = chain,
+    };
+  }
+
+private:
+  static void raw_handler() { mark(); }
+
+  static void function_handler() { m_function(); }
+
+  /// Stands in for reading a peripheral's status register
+  static bool source_fired() { return m_source_fired; }
+
+  static inline std::function<void()> m_function;
+  static inline volatile std::uint32_t m_pended_at = 0;
+  static inline volatile std::uint32_t m_latency = 0;
+  static inline volatile bool m_marked = false;
+  static inline volatile bool m_source_fired = true;
+};
+}  // namespace embed::cortex_m
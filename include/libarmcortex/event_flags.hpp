@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cstdint>
+
+#include "atomic.hpp"
+#include "wait_for_event.hpp"
+
+namespace embed::cortex_m {
+/**
+ * @brief A set of 32 event flags that interrupt service routines set and that
+ * threads wait on while sleeping in WFE.
+ *
+ * Setting flags is lock-free and safe from any interrupt. Waiters sleep with
+ * WFE rather than spinning on a volatile variable, and are woken by the SEV
+ * issued by set(). Waiting functions consume (clear) the flags they return so
+ * that each event is handled exactly once.
+ */
+class event_flags
+{
+public:
+  /**
+   * @brief Set flags and wake any waiters. Safe to call from an ISR.
+   *
+   * @param p_flags - flags to set
+   */
+  void set(std::uint32_t p_flags) noexcept
+  {
+    m_flags.fetch_or(p_flags, std::memory_order_release);
+    send_event();
+  }
+
+  /**
+   * @brief Clear flags without waiting on them.
+   *
+   * @param p_flags - flags to clear
+   */
+  void clear(std::uint32_t p_flags) noexcept
+  {
+    m_flags.fetch_and(~p_flags, std::memory_order_relaxed);
+  }
+
+  /// @return std::uint32_t - all flags currently set
+  [[nodiscard]] std::uint32_t get() const noexcept
+  {
+    return m_flags.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Consume any of the flags within the mask that are set, without
+   * waiting.
+   *
+   * @param p_mask - flags of interest
+   * @return std::uint32_t - the flags that were set and have now been cleared,
+   * zero if none were set.
+   */
+  [[nodiscard]] std::uint32_t try_wait_any(std::uint32_t p_mask) noexcept
+  {
+    auto flags = m_flags.load(std::memory_order_relaxed);
+    while ((flags & p_mask) != 0U) {
+      if (m_flags.compare_exchange_weak(flags,
+                                        flags & ~p_mask,
+                                        std::memory_order_acquire,
+                                        std::memory_order_relaxed)) {
+        return flags & p_mask;
+      }
+    }
+    return 0;
+  }
+
+  /**
+   * @brief Consume all of the flags within the mask if every one of them is
+   * set, without waiting.
+   *
+   * @param p_mask - flags of interest
+   * @return true - all flags were set and have now been cleared
+   * @return false - not all flags were set, nothing was cleared
+   */
+  [[nodiscard]] bool try_wait_all(std::uint32_t p_mask) noexcept
+  {
+    auto flags = m_flags.load(std::memory_order_relaxed);
+    while ((flags & p_mask) == p_mask) {
+      if (m_flags.compare_exchange_weak(flags,
+                                        flags & ~p_mask,
+                                        std::memory_order_acquire,
+                                        std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Sleep until any of the flags within the mask are set and consume
+   * them.
+   *
+   * @param p_mask - flags of interest
+   * @return std::uint32_t - the flags that were set and have now been cleared
+   */
+  std::uint32_t wait_any(std::uint32_t p_mask) noexcept
+  {
+    std::uint32_t flags = 0;
+    wait_for_event_until([&]() { return (flags = try_wait_any(p_mask)) != 0; });
+    return flags;
+  }
+
+  /**
+   * @brief Sleep until any of the flags within the mask are set and consume
+   * them, giving up after a timeout.
+   *
+   * See wait_for_event_until() for the timeout resolution.
+   *
+   * @param p_mask - flags of interest
+   * @param p_timeout_cycles - maximum number of CPU cycles to wait
+   * @return std::uint32_t - the flags that were set and have now been cleared,
+   * zero if the timeout elapsed.
+   */
+  [[nodiscard]] std::uint32_t wait_any_for(
+    std::uint32_t p_mask,
+    std::uint32_t p_timeout_cycles) noexcept
+  {
+    std::uint32_t flags = 0;
+    (void)wait_for_event_until(
+      [&]() { return (flags = try_wait_any(p_mask)) != 0; }, p_timeout_cycles);
+    return flags;
+  }
+
+  /**
+   * @brief Sleep until all of the flags within the mask are set and consume
+   * them.
+   *
+   * @param p_mask - flags of interest
+   */
+  void wait_all(std::uint32_t p_mask) noexcept
+  {
+    wait_for_event_until([&]() { return try_wait_all(p_mask); });
+  }
+
+  /**
+   * @brief Sleep until all of the flags within the mask are set and consume
+   * them, giving up after a timeout.
+   *
+   * See wait_for_event_until() for the timeout resolution.
+   *
+   * @param p_mask - flags of interest
+   * @param p_timeout_cycles - maximum number of CPU cycles to wait
+   * @return true - all flags were set and have now been cleared
+   * @return false - the timeout elapsed, nothing was cleared
+   */
+  [[nodiscard]] bool wait_all_for(std::uint32_t p_mask,
+                                  std::uint32_t p_timeout_cycles) noexcept
+  {
+    return wait_for_event_until([&]() { return try_wait_all(p_mask); },
+                                p_timeout_cycles);
+  }
+
+private:
+  atomic<std::uint32_t> m_flags{ 0 };
+};
+}  // namespace embed::cortex_m
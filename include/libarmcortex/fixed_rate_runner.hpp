@@ -0,0 +1,204 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+#include <libembeddedhal/error.hpp>
+#include <libembeddedhal/frequency.hpp>
+#include <libembeddedhal/timer/interface.hpp>
+
+#include "atomic.hpp"
+#include "dwt_counter.hpp"
+#include "histogram.hpp"
+
+namespace embed::cortex_m {
+/**
+ * @brief Runs a callback at a fixed rate from a periodic timer (normally
+ * systick_timer) while measuring its start time jitter and overruns with the
+ * DWT cycle counter.
+ *
+ * The runner is phase locked: each run is scheduled on a fixed grid of
+ * period-sized slots anchored at the first run, rather than relative to the
+ * previous run. So jitter in one run never shifts the ones after it.
+ *
+ * A run overruns when the callback has not returned by the start of the next
+ * slot. A long overrun can cover several slots, and the timer interrupt only
+ * latches one of them. The overrun_policy decides what happens to the others:
+ *
+ *   - skip: run once and continue with the next slot on the grid, dropping
+ *     the missed slots. Best for control loops that use the latest sample.
+ *   - catch_up: run back to back until every missed slot has been run, up to
+ *     max_catch_up runs per interrupt. Best for loops that integrate a fixed
+ *     time step per run.
+ *
+ * An interrupt that fires slightly before its slot, as timer jitter allows,
+ * runs that slot early and is recorded with zero jitter.
+ *
+ * All statistics are updated lock-free from the timer interrupt and can be
+ * read from any context at any time. The DWT cycle counter must have been
+ * started by constructing a dwt_counter.
+ */
+class fixed_rate_runner
+{
+public:
+  /// What to do with the slots missed during an overrun
+  enum class overrun_policy
+  {
+    /// Drop missed slots and continue on the grid
+    skip,
+    /// Run the callback once per missed slot
+    catch_up,
+  };
+
+  /// Maximum number of runs per timer interrupt when catching up
+  static constexpr std::uint32_t max_catch_up = 8;
+
+  /// Number of buckets in the jitter and overrun histograms
+  static constexpr std::size_t histogram_buckets = 16;
+
+  /// Histogram type used for the statistics
+  using histogram_t = histogram<histogram_buckets>;
+
+  /**
+   * @brief Construct a new fixed rate runner object
+   *
+   * @param p_timer - periodic timer driving the runner, such as systick_timer
+   * @param p_cpu_frequency - frequency of the DWT cycle counter
+   * @param p_bucket_cycles - cycles covered by each bucket of the jitter and
+   * overrun histograms
+   */
+  fixed_rate_runner(embed::timer& p_timer,
+                    frequency p_cpu_frequency,
+                    std::uint32_t p_bucket_cycles = 16)
+    : m_timer(&p_timer)
+    , m_cpu_frequency(p_cpu_frequency)
+    , m_jitter(p_bucket_cycles)
+    , m_overruns(p_bucket_cycles)
+  {}
+
+  fixed_rate_runner(const fixed_rate_runner&) = delete;
+  fixed_rate_runner& operator=(const fixed_rate_runner&) = delete;
+
+  /**
+   * @brief Start running the callback every period
+   *
+   * @param p_callback - function to run each period
+   * @param p_period - time between runs
+   * @param p_policy - what to do with slots missed during an overrun
+   * @return boost::leaf::result<void> - errors from scheduling the timer
+   */
+  boost::leaf::result<void> start(
+    std::function<void(void)> p_callback,
+    std::chrono::nanoseconds p_period,
+    overrun_policy p_policy = overrun_policy::skip)
+  {
+    const auto cycles = BOOST_LEAF_CHECK(m_cpu_frequency.cycles_per(p_period));
+    m_period_cycles = static_cast<std::uint32_t>(cycles > 0 ? cycles : 1);
+    m_callback = std::move(p_callback);
+    m_policy = p_policy;
+    m_started = false;
+    return m_timer->schedule([this]() { tick(); }, p_period);
+  }
+
+  /**
+   * @brief Stop running the callback
+   *
+   * @return boost::leaf::result<void> - errors from clearing the timer
+   */
+  boost::leaf::result<void> stop() { return m_timer->clear(); }
+
+  /// @return const histogram_t& - cycles between each run's slot and its start
+  [[nodiscard]] const histogram_t& jitter() const { return m_jitter; }
+
+  /// @return const histogram_t& - cycles each overrun extended past its slot
+  [[nodiscard]] const histogram_t& overruns() const { return m_overruns; }
+
+  /// @return std::uint32_t - number of runs that overran their slot
+  [[nodiscard]] std::uint32_t overrun_count() const
+  {
+    return m_overrun_count.load(std::memory_order_relaxed);
+  }
+
+  /// @return std::uint32_t - number of slots dropped without a run
+  [[nodiscard]] std::uint32_t skipped() const
+  {
+    return m_skipped.load(std::memory_order_relaxed);
+  }
+
+  /// @return std::uint32_t - number of times the callback has run
+  [[nodiscard]] std::uint32_t runs() const
+  {
+    return m_runs.load(std::memory_order_relaxed);
+  }
+
+  /// @return std::uint32_t - worst case cycles from a slot to its run
+  [[nodiscard]] std::uint32_t worst_latency() const { return m_jitter.max(); }
+
+private:
+  void tick()
+  {
+    const std::uint32_t now = dwt_counter::dwt()->cyccnt;
+    if (!m_started) {
+      m_next_slot = now;
+      m_started = true;
+    }
+
+    // Slots that passed entirely while the previous run overran. Timer
+    // jitter can fire the interrupt slightly before its slot, in which case
+    // the slot is run early rather than treated as ~2^32 cycles late.
+    const auto late = cycles_after(now, m_next_slot);
+    std::uint32_t missed =
+      late > 0 ? static_cast<std::uint32_t>(late) / m_period_cycles : 0;
+    if (m_policy == overrun_policy::skip || missed >= max_catch_up) {
+      const auto dropped = m_policy == overrun_policy::skip
+                             ? missed
+                             : missed - (max_catch_up - 1);
+      m_skipped.fetch_add(dropped, std::memory_order_relaxed);
+      m_next_slot += dropped * m_period_cycles;
+      missed -= dropped;
+    }
+
+    for (std::uint32_t i = 0; i <= missed; i++) {
+      run(m_next_slot);
+      m_next_slot += m_period_cycles;
+    }
+  }
+
+  void run(std::uint32_t p_slot)
+  {
+    const auto start = cycles_after(dwt_counter::dwt()->cyccnt, p_slot);
+    m_jitter.record(start > 0 ? static_cast<std::uint32_t>(start) : 0);
+
+    m_callback();
+    m_runs.fetch_add(1, std::memory_order_relaxed);
+
+    const auto elapsed = cycles_after(dwt_counter::dwt()->cyccnt, p_slot);
+    if (elapsed > 0 && static_cast<std::uint32_t>(elapsed) > m_period_cycles) {
+      m_overrun_count.fetch_add(1, std::memory_order_relaxed);
+      m_overruns.record(static_cast<std::uint32_t>(elapsed) - m_period_cycles);
+    }
+  }
+
+  /// Signed cycles from p_slot to p_now, negative when p_now is before the
+  /// slot, correct across cycle counter wrap around
+  static std::int32_t cycles_after(std::uint32_t p_now, std::uint32_t p_slot)
+  {
+    return static_cast<std::int32_t>(p_now - p_slot);
+  }
+
+  embed::timer* m_timer;
+  frequency m_cpu_frequency;
+  std::function<void(void)> m_callback{};
+  std::uint32_t m_period_cycles = 1;
+  std::uint32_t m_next_slot = 0;
+  overrun_policy m_policy = overrun_policy::skip;
+  bool m_started = false;
+  histogram_t m_jitter;
+  histogram_t m_overruns;
+  atomic<std::uint32_t> m_overrun_count{ 0 };
+  atomic<std::uint32_t> m_skipped{ 0 };
+  atomic<std::uint32_t> m_runs{ 0 };
+};
+}  // namespace embed::cortex_m
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "atomic.hpp"
+
+namespace embed::cortex_m {
+/**
+ * @brief Fixed size, lock-free histogram of 32-bit samples such as cycle
+ * counts.
+ *
+ * Samples are sorted into Buckets linear buckets of a fixed width, with the
+ * last bucket also collecting every sample beyond the range of the others.
+ * The largest sample is tracked exactly. Recording is wait-free for a single
+ * writer and lock-free for several, so samples can be recorded from interrupt
+ * service routines while another context reads the histogram.
+ *
+ * @tparam Buckets - number of buckets
+ */
+template<std::size_t Buckets>
+class histogram
+{
+public:
+  static_assert(Buckets > 0, "histogram needs at least one bucket");
+
+  /**
+   * @brief Construct a new histogram object
+   *
+   * @param p_bucket_width - range of sample values each bucket covers, must be
+   * greater than zero
+   */
+  explicit histogram(std::uint32_t p_bucket_width) noexcept
+    : m_bucket_width(p_bucket_width == 0 ? 1 : p_bucket_width)
+  {}
+
+  /**
+   * @brief Add a sample to the histogram
+   *
+   * @param p_value - sample value
+   */
+  void record(std::uint32_t p_value) noexcept
+  {
+    auto bucket = static_cast<std::size_t>(p_value / m_bucket_width);
+    if (bucket >= Buckets) {
+      bucket = Buckets - 1;
+    }
+    m_counts[bucket].fetch_add(1, std::memory_order_relaxed);
+
+    auto maximum = m_maximum.load(std::memory_order_relaxed);
+    while (p_value > maximum &&
+           !m_maximum.compare_exchange_weak(maximum,
+                                            p_value,
+                                            std::memory_order_relaxed,
+                                            std::memory_order_relaxed)) {
+    }
+  }
+
+  /**
+   * @param p_bucket - bucket index
+   * @return std::uint32_t - number of samples in the bucket. Bucket N holds
+   * samples from N * bucket_width() up to, but excluding, (N + 1) *
+   * bucket_width().
+   */
+  [[nodiscard]] std::uint32_t count(std::size_t p_bucket) const noexcept
+  {
+    return m_counts[p_bucket].load(std::memory_order_relaxed);
+  }
+
+  /// @return std::uint32_t - number of samples across every bucket
+  [[nodiscard]] std::uint32_t total() const noexcept
+  {
+    std::uint32_t sum = 0;
+    for (const auto& count : m_counts) {
+      sum += count.load(std::memory_order_relaxed);
+    }
+    return sum;
+  }
+
+  /// @return std::uint32_t - largest sample recorded
+  [[nodiscard]] std::uint32_t max() const noexcept
+  {
+    return m_maximum.load(std::memory_order_relaxed);
+  }
+
+  /// @return std::uint32_t - range of sample values each bucket covers
+  [[nodiscard]] std::uint32_t bucket_width() const noexcept
+  {
+    return m_bucket_width;
+  }
+
+  /// @return constexpr std::size_t - number of buckets
+  [[nodiscard]] static constexpr std::size_t size() noexcept { return Buckets; }
+
+  /// Discard every sample. Samples recorded concurrently may be kept.
+  void reset() noexcept
+  {
+    for (auto& count : m_counts) {
+      count.store(0, std::memory_order_relaxed);
+    }
+    m_maximum.store(0, std::memory_order_relaxed);
+  }
+
+private:
+  std::uint32_t m_bucket_width;
+  std::array<atomic<std::uint32_t>, Buckets> m_counts{};
+  atomic<std::uint32_t> m_maximum{ 0 };
+};
+}  // namespace embed::cortex_m
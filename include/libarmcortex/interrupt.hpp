@@ -2,6 +2,8 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <span>
 #include <utility>
@@ -9,6 +11,10 @@
 #include <libembeddedhal/config.hpp>
 #include <libembeddedhal/error.hpp>
 
+#include "atomic.hpp"
+#include "barrier.hpp"
+#include "config.hpp"
+#include "critical_section.hpp"
 #include "system_control.hpp"
 
 namespace embed::cortex_m {
@@ -231,6 +237,34 @@ public:
     int end{};
   };
 
+  /**
+   * @brief Error indicating that every slot in a shared interrupt's handler
+   * chain is already in use.
+   *
+   */
+  struct handler_chain_full
+  {
+    /// IRQ whose chain is full
+    int irq;
+    /// Number of handlers the chain can hold
+    std::size_t capacity;
+  };
+
+  /**
+   * @brief Error indicating that a handler was attached to a shared interrupt
+   * with a different capacity than the handlers already attached to it.
+   *
+   */
+  struct handler_chain_capacity_mismatch
+  {
+    /// IRQ of the chain
+    int irq;
+    /// Capacity requested by the rejected call
+    std::size_t capacity;
+    /// Capacity of the chain already installed on the IRQ
+    std::size_t installed_capacity;
+  };
+
   /// Place holder interrupt that performs no work
   static void nop() {}
 
@@ -322,6 +356,252 @@ public:
    */
   static const auto& get_vector_table() { return vector_table; }
 
+  /// Mask for the active vector number in the IPSR and ICSR (VECTACTIVE)
+  static constexpr uint32_t active_vector_mask = 0x1FF;
+
+  /**
+   * @brief Get the IRQ number of the exception currently being serviced.
+   *
+   * Allows a single handler installed on several vectors to determine which
+   * one it was invoked for. Reads the IPSR on hardware, which costs a single
+   * instruction. When running as a test, the VECTACTIVE field of the ICSR
+   * within the dummy system control block is used instead so that tests can
+   * choose the active vector.
+   *
+   * @return int - the active IRQ number, or -core_interrupts when called from
+   * thread mode.
+   */
+  static int active_irq()
+  {
+    uint32_t vector = 0;
+    if constexpr (embed::is_a_test()) {
+      vector = system_control::scb()->icsr & active_vector_mask;
+    } else {
+      asm volatile("mrs %0, ipsr" : "=r"(vector));
+      vector = vector & active_vector_mask;
+    }
+    return static_cast<int>(vector) - core_interrupts;
+  }
+
+  /**
+   * @brief Interrupt service routine that wraps a handler with hooks.
+   *
+   * Each hook type must provide `static void enter(int p_irq)` and
+   * `static void exit(int p_irq)`. Enter hooks are called in order before the
+   * handler and exit hooks in reverse order after it, each with the IRQ number
+   * of the active vector. Everything is resolved at compile time, so the
+   * trampoline costs nothing beyond the hooks themselves.
+   *
+   * The trampoline is flattened: the hooks and, when its definition is
+   * visible, the handler are inlined into it, so the vector points at a
+   * single function with one prologue and no further calls. Use it to install
+   * handlers that are defined in a header or the same translation unit when
+   * entry latency matters, see entry_latency.
+   *
+   * Usage: `interrupt(irq).enable(interrupt::trampoline<handler, trace>)`
+   *
+   * @tparam Handler - interrupt service routine to wrap
+   * @tparam Hooks - types providing static enter and exit functions
+   */
+  template<interrupt_pointer Handler, typename... Hooks>
+  [[gnu::flatten]] static void trampoline()
+  {
+    if constexpr (sizeof...(Hooks) == 0) {
+      Handler();
+    } else {
+      call_with_hooks<Handler, Hooks...>(active_irq());
+    }
+  }
+
+  /**
+   * @brief Compile time description of a handler on a shared interrupt line,
+   * for use with chain().
+   *
+   * @tparam Handler - routine to service the source
+   * @tparam Fired - returns true if the source has fired and needs servicing.
+   * If null, the handler is always called.
+   */
+  template<interrupt_pointer Handler, bool (*Fired)() = nullptr>
+  struct shared_source
+  {
+    /// Call the handler if the source has fired
+    static void service()
+    {
+      if constexpr (Fired == nullptr) {
+        Handler();
+      } else if (Fired()) {
+        Handler();
+      }
+    }
+  };
+
+  /**
+   * @brief Interrupt service routine that dispatches a shared interrupt line
+   * to a fixed set of handlers.
+   *
+   * The chain is unrolled at compile time, so each source costs a direct call
+   * to its predicate (if any) and a direct call to its handler, both of which
+   * can be inlined. Sources are serviced in the order given.
+   *
+   * Usage:
+   *
+   *     interrupt(irq).enable(interrupt::chain<
+   *       interrupt::shared_source<uart0_isr, uart0_fired>,
+   *       interrupt::shared_source<uart1_isr, uart1_fired>>);
+   *
+   * @tparam Sources - shared_source types for each handler on the line
+   */
+  template<typename... Sources>
+  [[gnu::flatten]] static void chain()
+  {
+    (Sources::service(), ...);
+  }
+
+  /**
+   * @brief Attach a handler to a shared interrupt line at runtime.
+   *
+   * The first handler attached to the IRQ installs a dispatcher in the vector
+   * table and enables the interrupt. Each call adds one handler to a
+   * statically allocated chain for the IRQ, and the dispatcher calls every
+   * attached handler whose predicate reports that its source fired, in the
+   * order they were attached. Handlers can be attached while the interrupt is
+   * enabled, but a handler attached while the dispatcher is running may not be
+   * called until the next interrupt.
+   *
+   * When the set of handlers is known at compile time, prefer chain(), which
+   * avoids the loop and indirect calls.
+   *
+   * @tparam Irq - interrupt line shared by the handlers
+   * @tparam Capacity - maximum number of handlers on the line, must be the
+   * same for every call for the same IRQ
+   * @param p_handler - routine to service the source
+   * @param p_fired - returns true if the source needs servicing. Pass nullptr
+   * to always call the handler.
+   * @return boost::leaf::result<void> - fails with handler_chain_full if
+   * Capacity handlers are already attached, handler_chain_capacity_mismatch if
+   * a chain with another capacity is installed on the IRQ, or the errors of
+   * enable().
+   */
+  template<int Irq, std::size_t Capacity = 4>
+  static boost::leaf::result<void> attach(interrupt_pointer p_handler,
+                                          bool (*p_fired)() = nullptr)
+  {
+    static_assert(Capacity > 0, "A handler chain must hold a handler");
+
+    auto& installed_capacity = shared_capacity<Irq>();
+    if (installed_capacity != 0 && installed_capacity != Capacity) {
+      return boost::leaf::new_error(handler_chain_capacity_mismatch{
+        .irq = Irq,
+        .capacity = Capacity,
+        .installed_capacity = installed_capacity,
+      });
+    }
+
+    auto& chain = shared_chain<Irq, Capacity>();
+    const auto count = chain.count.load(std::memory_order_relaxed);
+
+    if (count >= Capacity) {
+      return boost::leaf::new_error(
+        handler_chain_full{ .irq = Irq, .capacity = Capacity });
+    }
+
+    // Publish the handler before the dispatcher can observe it
+    chain.handlers[count] = { .handler = p_handler, .fired = p_fired };
+    chain.count.store(count + 1, std::memory_order_release);
+
+    if (count == 0) {
+      auto enabled = interrupt(Irq).enable(shared_dispatch<Irq, Capacity>);
+      if (!enabled) {
+        chain.count.store(0, std::memory_order_relaxed);
+        return enabled;
+      }
+      installed_capacity = Capacity;
+    }
+    return {};
+  }
+
+  /**
+   * @brief A set of zero latency interrupts, which are never masked by the
+   * library.
+   *
+   * Critical sections raise BASEPRI to Threshold rather than setting PRIMASK
+   * (see critical_section), so interrupts with a priority value below
+   * Threshold are never delayed by library code. Use it for handlers, such as
+   * motor commutation, that cannot tolerate any added latency.
+   *
+   * Zero latency handlers must not call anything that takes a critical
+   * section, because it cannot exclude them. On ARMv7-M and above, the
+   * library's atomics and queues are lock-free and safe to use. Wrap the
+   * handlers with the set as a trampoline hook to have critical sections
+   * entered from them abort:
+   *
+   *     using motor = interrupt::zero_latency<pwm_irq, hall_irq>;
+   *     motor::set_priority<0x00>();
+   *     interrupt(pwm_irq).enable(interrupt::trampoline<pwm_handler, motor>);
+   *
+   * Zero latency interrupts need BASEPRI, so ARMv6-M is rejected at compile
+   * time.
+   *
+   * @tparam Threshold - BASEPRI value used by critical sections, normally
+   * config::zero_latency_threshold
+   * @tparam Irqs - IRQ numbers of the zero latency interrupts
+   */
+  template<std::uint8_t Threshold, int... Irqs>
+  struct basic_zero_latency
+  {
+    static_assert(Threshold != 0,
+                  "Set LIBARMCORTEX_ZERO_LATENCY_THRESHOLD to the BASEPRI "
+                  "value that critical sections mask with");
+    static_assert(has_basepri,
+                  "Zero latency interrupts need BASEPRI, which ARMv6-M lacks");
+    static_assert(((Irqs >= -12) && ...),
+                  "NMI and HardFault cannot be masked and need not be listed");
+
+    /**
+     * @param p_irq - IRQ number
+     * @return true - the IRQ is in the set
+     */
+    static constexpr bool contains(int p_irq)
+    {
+      return ((p_irq == Irqs) || ...);
+    }
+
+    /**
+     * @brief Program the priority of every interrupt in the set
+     *
+     * @tparam Priority - priority value, must be below the threshold
+     * @return boost::leaf::result<void> - errors of interrupt::set_priority()
+     */
+    template<std::uint8_t Priority>
+    static boost::leaf::result<void> set_priority()
+    {
+      static_assert(Priority < Threshold,
+                    "A zero latency interrupt needs a priority value below the "
+                    "masking threshold");
+      for (int irq : { Irqs... }) {
+        BOOST_LEAF_CHECK(interrupt(irq).set_priority(Priority));
+      }
+      return {};
+    }
+
+    /// interrupt::trampoline hook, marks the start of a zero latency handler
+    static void enter([[maybe_unused]] int p_irq) noexcept
+    {
+      critical_section::zero_latency_context::enter();
+    }
+
+    /// interrupt::trampoline hook, marks the end of a zero latency handler
+    static void exit([[maybe_unused]] int p_irq) noexcept
+    {
+      critical_section::zero_latency_context::exit();
+    }
+  };
+
+  /// Zero latency interrupts masked at config::zero_latency_threshold
+  template<int... Irqs>
+  using zero_latency =
+    basic_zero_latency<config::zero_latency_threshold, Irqs...>;
+
   /**
    * @brief Construct a new interrupt object
    *
@@ -334,6 +614,11 @@ public:
   /**
    * @brief enable interrupt and set the service routine handler.
    *
+   * The handler is installed with a single aligned store, followed by
+   * barriers, before the interrupt is enabled. So the first interrupt after
+   * enabling always runs the new handler. If the interrupt was already
+   * enabled, this behaves like replace().
+   *
    * @param p_handler - the interrupt service routine handler to be executed
    * when the hardware interrupt is fired.
    * @return true - successfully installed handler and enabled interrupt
@@ -343,7 +628,7 @@ public:
   {
     BOOST_LEAF_CHECK(sanity_check());
 
-    vector_table[m_irq.vector_index()] = p_handler;
+    store_handler(p_handler);
 
     if (!m_irq.default_enabled()) {
       nvic_enable_irq();
@@ -354,6 +639,14 @@ public:
   /**
    * @brief disable interrupt and set the service routine handler to "nop".
    *
+   * The interrupt is disabled in the NVIC and the barriers complete before
+   * "nop" is installed. This means an interrupt arriving during the call
+   * either runs the previous handler or stays pending in the NVIC until the
+   * interrupt is enabled again. It is never consumed by "nop".
+   *
+   * The previous handler may still be executing when this returns if it was
+   * preempted. Call drain() afterwards to wait for it to finish.
+   *
    * @return true - successfully disabled interrupt
    * @return false - irq value is outside of the bounds of the table
    */
@@ -361,7 +654,89 @@ public:
   {
     BOOST_LEAF_CHECK(sanity_check());
 
-    vector_table[m_irq.vector_index()] = nop;
+    if (!m_irq.default_enabled()) {
+      nvic_disable_irq();
+    }
+
+    store_handler(nop);
+    return {};
+  }
+
+  /**
+   * @brief Swap the service routine handler of a live interrupt without
+   * masking it.
+   *
+   * The handler is replaced with a single aligned word store, so the hardware
+   * always fetches either the old or the new handler and never a torn
+   * address. Barriers after the store make sure every interrupt taken after
+   * this returns runs the new handler. The enable state of the interrupt is
+   * left untouched and no interrupt is lost or masked during the swap. This
+   * makes it suitable for switching between implementations, such as a fast
+   * path and a diagnostics path, under full load.
+   *
+   * An invocation of the old handler that started before the swap may still
+   * be running when the store completes, for example if this is called from a
+   * higher priority context. Pass p_drain to wait until it has returned before
+   * reusing anything the old handler depends on.
+   *
+   * @param p_handler - the new interrupt service routine handler
+   * @param p_drain - wait for in-flight invocations of the old handler
+   * @return boost::leaf::result<void> - fails if the vector table is not
+   * initialized or the irq is out of bounds
+   */
+  [[nodiscard]] boost::leaf::result<void> replace(interrupt_pointer p_handler,
+                                                  bool p_drain = false)
+  {
+    BOOST_LEAF_CHECK(sanity_check());
+
+    store_handler(p_handler);
+
+    if (p_drain) {
+      BOOST_LEAF_CHECK(drain());
+    }
+    return {};
+  }
+
+  /**
+   * @brief Wait until the interrupt is no longer active, meaning any
+   * invocation of its handler that already started has returned.
+   *
+   * Polls the NVIC's interrupt active bit register (IABR). It returns
+   * immediately for core exceptions, which have no IABR bit, and when called
+   * from within the interrupt's own handler, which would otherwise never
+   * return. It must not be called from a context with higher priority than a
+   * handler that is preempted by it, because that handler can never complete.
+   *
+   * @return boost::leaf::result<void> - fails if the vector table is not
+   * initialized or the irq is out of bounds
+   */
+  [[nodiscard]] boost::leaf::result<void> drain()
+  {
+    BOOST_LEAF_CHECK(sanity_check());
+
+    if (m_irq.default_enabled() || active_irq() == m_irq.get_irq_number()) {
+      return {};
+    }
+
+    const auto& active = nvic()->iabr.at(m_irq.register_index());
+    while ((active & m_irq.enable_mask()) != 0U) {
+    }
+    return {};
+  }
+
+  /**
+   * @brief Stop the interrupt from being taken without removing its handler.
+   *
+   * Clears the interrupt's enable bit through the NVIC's ICER. A request that
+   * arrives while masked stays pending and is taken once unmasked. Core
+   * exceptions cannot be masked in the NVIC, so this does nothing for them.
+   *
+   * @return boost::leaf::result<void> - fails if the vector table is not
+   * initialized or the irq is out of bounds
+   */
+  [[nodiscard]] boost::leaf::result<void> mask()
+  {
+    BOOST_LEAF_CHECK(sanity_check());
 
     if (!m_irq.default_enabled()) {
       nvic_disable_irq();
@@ -369,6 +744,95 @@ public:
     return {};
   }
 
+  /**
+   * @brief Allow a masked interrupt to be taken again with its current
+   * handler.
+   *
+   * @return boost::leaf::result<void> - fails if the vector table is not
+   * initialized or the irq is out of bounds
+   */
+  [[nodiscard]] boost::leaf::result<void> unmask()
+  {
+    BOOST_LEAF_CHECK(sanity_check());
+
+    if (!m_irq.default_enabled()) {
+      nvic_enable_irq();
+    }
+    return {};
+  }
+
+  /**
+   * @brief Request the interrupt from software through the NVIC's STIR.
+   *
+   * The interrupt is taken as soon as its priority allows, as if the
+   * peripheral had raised it. Only device interrupts can be pended this way.
+   * Writing STIR from unprivileged code requires SCB->CCR.USERSETMPEND.
+   *
+   * @return boost::leaf::result<void> - fails if the vector table is not
+   * initialized or the irq is out of bounds or a core exception
+   */
+  [[nodiscard]] boost::leaf::result<void> pend()
+  {
+    BOOST_LEAF_CHECK(sanity_check());
+
+    if (m_irq.default_enabled()) {
+      return boost::leaf::new_error(invalid_irq(m_irq));
+    }
+    nvic()->stir = static_cast<std::uint32_t>(m_irq.get_irq_number());
+    return {};
+  }
+
+  /**
+   * @brief Set the priority of the interrupt.
+   *
+   * Lower values preempt higher values. Devices only implement the most
+   * significant bits of the value, commonly 2 to 4 of them, and the rest read
+   * as zero. NMI and HardFault have fixed priorities and cannot be changed.
+   *
+   * @param p_priority - priority value
+   * @return boost::leaf::result<void> - fails if the vector table is not
+   * initialized or the irq is out of bounds or has a fixed priority
+   */
+  [[nodiscard]] boost::leaf::result<void> set_priority(std::uint8_t p_priority)
+  {
+    BOOST_LEAF_CHECK(sanity_check());
+
+    static constexpr int first_configurable = -12;
+    const int irq = m_irq.get_irq_number();
+    if (irq >= 0) {
+      nvic()->ip.at(static_cast<std::size_t>(irq)) = p_priority;
+    } else if (irq >= first_configurable) {
+      system_control::scb()->shp.at(
+        static_cast<std::size_t>(irq - first_configurable)) = p_priority;
+    } else {
+      return boost::leaf::new_error(invalid_irq(m_irq));
+    }
+    return {};
+  }
+
+  /**
+   * @brief Get the priority of the interrupt as programmed in the NVIC or SCB
+   *
+   * @return boost::leaf::result<std::uint8_t> - priority value, fails if the
+   * vector table is not initialized or the irq is out of bounds or has a
+   * fixed priority
+   */
+  [[nodiscard]] boost::leaf::result<std::uint8_t> get_priority()
+  {
+    BOOST_LEAF_CHECK(sanity_check());
+
+    static constexpr int first_configurable = -12;
+    const int irq = m_irq.get_irq_number();
+    if (irq >= 0) {
+      return nvic()->ip.at(static_cast<std::size_t>(irq));
+    }
+    if (irq >= first_configurable) {
+      return system_control::scb()->shp.at(
+        static_cast<std::size_t>(irq - first_configurable));
+    }
+    return boost::leaf::new_error(invalid_irq(m_irq));
+  }
+
   /**
    * @brief determine if a particular handler has been put into the interrupt
    * vector table.
@@ -401,6 +865,65 @@ public:
   }
 
 private:
+  struct shared_handler
+  {
+    interrupt_pointer handler;
+    bool (*fired)();
+  };
+
+  template<std::size_t Capacity>
+  struct shared_chain_t
+  {
+    std::array<shared_handler, Capacity> handlers;
+    atomic<std::uint32_t> count;
+  };
+
+  template<int Irq, std::size_t Capacity>
+  static shared_chain_t<Capacity>& shared_chain()
+  {
+    static shared_chain_t<Capacity> chain{};
+    return chain;
+  }
+
+  /// Capacity of the chain attach() installed on the IRQ, 0 if none
+  template<int Irq>
+  static std::size_t& shared_capacity()
+  {
+    static std::size_t capacity = 0;
+    return capacity;
+  }
+
+  template<int Irq, std::size_t Capacity>
+  static void shared_dispatch()
+  {
+    auto& chain = shared_chain<Irq, Capacity>();
+    const auto count = chain.count.load(std::memory_order_acquire);
+    for (std::uint32_t i = 0; i < count; i++) {
+      dispatch(chain.handlers[i]);
+    }
+  }
+
+  static void dispatch(const shared_handler& p_handler)
+  {
+    if (p_handler.fired == nullptr || p_handler.fired()) {
+      p_handler.handler();
+    }
+  }
+
+  template<interrupt_pointer Handler, typename Hook, typename... Rest>
+  [[gnu::always_inline]] static void call_with_hooks(int p_irq)
+  {
+    Hook::enter(p_irq);
+    call_with_hooks<Handler, Rest...>(p_irq);
+    Hook::exit(p_irq);
+  }
+
+  template<interrupt_pointer Handler>
+  [[gnu::always_inline]] static void call_with_hooks(int)
+  {
+    Handler();
+  }
+
   boost::leaf::result<void> sanity_check()
   {
     if (!vector_table_is_initialized()) {
@@ -414,6 +937,16 @@ private:
     return {};
   }
 
+  /// Install a handler with a single word store that the NVIC observes
+  /// atomically, then make sure it is visible before continuing.
+  void store_handler(interrupt_pointer p_handler)
+  {
+    std::atomic_ref(vector_table[m_irq.vector_index()])
+      .store(p_handler, std::memory_order_release);
+    data_synchronization_barrier();
+    instruction_synchronization_barrier();
+  }
+
   bool vector_table_is_initialized()
   {
     return system_control().get_interrupt_vector_table_address() != 0x0000'0000;
@@ -439,6 +972,10 @@ private:
   {
     auto* interrupt_clear = &nvic()->icer.at(m_irq.register_index());
     *interrupt_clear = m_irq.enable_mask();
+    // Make sure the interrupt is disabled before the caller continues, so it
+    // cannot be taken after this returns.
+    data_synchronization_barrier();
+    instruction_synchronization_barrier();
   }
 
   irq_t m_irq;
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+#include "atomic.hpp"
+#include "dwt_counter.hpp"
+#include "interrupt.hpp"
+
+namespace embed::cortex_m {
+/// isr_budget overrun action that only counts the overrun
+struct ignore_overrun
+{
+  /**
+   * @param p_irq - IRQ number of the handler that overran
+   * @param p_cycles - cycles the handler took
+   */
+  static void overrun([[maybe_unused]] int p_irq,
+                      [[maybe_unused]] std::uint32_t p_cycles) noexcept
+  {}
+};
+
+/// isr_budget overrun action that masks the interrupt in the NVIC so it can no
+/// longer starve lower priority work. interrupt::unmask() re-enables it.
+struct mask_on_overrun
+{
+  /**
+   * @param p_irq - IRQ number of the handler that overran
+   * @param p_cycles - cycles the handler took
+   */
+  static void overrun(int p_irq,
+                      [[maybe_unused]] std::uint32_t p_cycles) noexcept
+  {
+    (void)interrupt(p_irq).mask();
+  }
+};
+
+/// isr_budget overrun action that escalates to a system failure by aborting,
+/// for systems where a late interrupt is a safety violation
+struct abort_on_overrun
+{
+  /**
+   * @param p_irq - IRQ number of the handler that overran
+   * @param p_cycles - cycles the handler took
+   */
+  [[noreturn]] static void overrun([[maybe_unused]] int p_irq,
+                                   [[maybe_unused]] std::uint32_t p_cycles)
+  {
+    std::abort();
+  }
+};
+
+/**
+ * @brief interrupt::trampoline hook that enforces an execution budget in CPU
+ * cycles on an interrupt service routine.
+ *
+ * The enter hook stores the DWT cycle count and the exit hook checks how long
+ * the handler took. When it exceeds the budget, the overrun is counted and
+ * Action::overrun(irq, cycles) is called. The path where the handler stays
+ * within its budget costs two cycle counter reads, a store and a compare.
+ *
+ *     interrupt(irq).enable(
+ *       interrupt::trampoline<handler, isr_budget<2'000, mask_on_overrun>>);
+ *
+ * The check runs when the handler returns, so a handler that never returns is
+ * not caught and is left to the watchdog. Time spent in higher priority
+ * interrupts that preempt the handler counts toward its budget, since it
+ * delays lower priority work just as much.
+ *
+ * One isr_budget type can be shared by several interrupts. Start times are
+ * kept on a small stack, which stays consistent because interrupts nest
+ * strictly. Handlers nested deeper than MaxNesting are not checked. The DWT
+ * cycle counter must have been started by constructing a dwt_counter.
+ *
+ * @tparam BudgetCycles - most cycles the handler may take
+ * @tparam Action - type with a static overrun(int, std::uint32_t) function,
+ * such as ignore_overrun, mask_on_overrun or abort_on_overrun
+ * @tparam MaxNesting - most handlers sharing this type that can be nested
+ */
+template<std::uint32_t BudgetCycles,
+         typename Action = ignore_overrun,
+         std::size_t MaxNesting = 8>
+class isr_budget
+{
+public:
+  /// Most cycles the handler may take
+  static constexpr std::uint32_t budget = BudgetCycles;
+
+  /// interrupt::trampoline hook, records when the handler started
+  static void enter([[maybe_unused]] int p_irq) noexcept
+  {
+    // Claim the slot before filling it, so a nested handler that preempts in
+    // between uses the next one.
+    const auto depth = m_depth.load(std::memory_order_relaxed);
+    m_depth.store(depth + 1, std::memory_order_relaxed);
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    if (depth < MaxNesting) {
+      m_start[depth] = dwt_counter::dwt()->cyccnt;
+    }
+  }
+
+  /// interrupt::trampoline hook, calls the overrun action if the handler took
+  /// longer than its budget
+  static void exit(int p_irq) noexcept(noexcept(Action::overrun(0, 0)))
+  {
+    const auto depth = m_depth.load(std::memory_order_relaxed) - 1;
+    std::uint32_t elapsed = 0;
+    if (depth < MaxNesting) {
+      elapsed = dwt_counter::dwt()->cyccnt - m_start[depth];
+    }
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    m_depth.store(depth, std::memory_order_relaxed);
+
+    if (elapsed > BudgetCycles) {
+      m_overruns.fetch_add(1, std::memory_order_relaxed);
+      if (elapsed > m_worst.load(std::memory_order_relaxed)) {
+        m_worst.store(elapsed, std::memory_order_relaxed);
+      }
+      Action::overrun(p_irq, elapsed);
+    }
+  }
+
+  /// @return std::uint32_t - number of times a handler exceeded the budget
+  static std::uint32_t overruns() noexcept
+  {
+    return m_overruns.load(std::memory_order_relaxed);
+  }
+
+  /// @return std::uint32_t - most cycles taken by a handler that overran
+  static std::uint32_t worst_overrun() noexcept
+  {
+    return m_worst.load(std::memory_order_relaxed);
+  }
+
+  /// Clear the overrun statistics
+  static void reset() noexcept
+  {
+    m_overruns.store(0, std::memory_order_relaxed);
+    m_worst.store(0, std::memory_order_relaxed);
+  }
+
+private:
+  static inline std::array<std::uint32_t, MaxNesting> m_start{};
+  static inline atomic<std::uint32_t> m_depth{ 0 };
+  static inline atomic<std::uint32_t> m_overruns{ 0 };
+  static inline atomic<std::uint32_t> m_worst{ 0 };
+};
+}  // namespace embed::cortex_m
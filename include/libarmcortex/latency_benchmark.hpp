@@ -0,0 +1,402 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+
+#include <libembeddedhal/config.hpp>
+#include <libembeddedhal/error.hpp>
+
+#include "barrier.hpp"
+#include "config.hpp"
+#include "critical_section.hpp"
+#include "csv_writer.hpp"
+#include "cycle_cost.hpp"
+#include "entry_latency.hpp"
+#include "interrupt.hpp"
+#include "nvic_model.hpp"
+#include "system_control.hpp"
+
+namespace embed::cortex_m {
+/// Configurations measured by latency_benchmark
+enum class latency_scenario : std::uint8_t
+{
+  /// Vector table in RAM, as set up by interrupt::initialize()
+  ram_vector_table,
+  /// Vector table in flash
+  flash_vector_table,
+  /// Floating point context in use with lazy stacking enabled
+  fpu_lazy_stacking,
+  /// Floating point context in use with lazy stacking disabled
+  fpu_full_stacking,
+  /// Interrupt taken on return from another handler, measured from the
+  /// other handler's last instruction
+  tail_chain,
+  /// Interrupt preempting a lower priority handler
+  nested_preemption,
+};
+
+/// Number of latency_scenario values
+inline constexpr std::size_t latency_scenario_count = 6;
+
+/**
+ * @param p_scenario - scenario
+ * @return const char* - name of the scenario
+ */
+constexpr const char* to_string(latency_scenario p_scenario)
+{
+  switch (p_scenario) {
+    case latency_scenario::ram_vector_table:
+      return "ram_vector_table";
+    case latency_scenario::flash_vector_table:
+      return "flash_vector_table";
+    case latency_scenario::fpu_lazy_stacking:
+      return "fpu_lazy_stacking";
+    case latency_scenario::fpu_full_stacking:
+      return "fpu_full_stacking";
+    case latency_scenario::tail_chain:
+      return "tail_chain";
+    case latency_scenario::nested_preemption:
+      return "nested_preemption";
+  }
+  return "unknown";
+}
+
+/// Trigger to handler latency of one scenario in CPU cycles
+struct latency_result
+{
+  /// Scenario measured
+  latency_scenario scenario;
+  /// Fewest cycles seen
+  std::uint32_t min;
+  /// Most cycles seen
+  std::uint32_t max;
+  /// Number of samples taken
+  std::uint32_t samples;
+};
+
+/// Timing parameters of the simulated NVIC, see latency_benchmark::simulate()
+struct latency_model
+{
+  /// Cycles from an interrupt being taken to the first instruction of its
+  /// handler with the vector table in zero wait state memory
+  std::uint32_t entry_cycles = 12;
+  /// Cycles from a handler returning to the first instruction of a pending
+  /// handler
+  std::uint32_t tail_chain_cycles = 6;
+  /// Extra cycles to fetch the vector from flash
+  std::uint32_t flash_wait_states = 0;
+  /// Extra cycles to stack the floating point registers on entry when lazy
+  /// stacking is disabled
+  std::uint32_t fpu_stacking_cycles = 17;
+};
+
+/**
+ * @brief Format latency benchmark results as CSV, a header line and then one
+ * scenario per line.
+ *
+ * @param p_results - results to format
+ * @param p_buffer - destination, truncated as described by csv_writer
+ * @return std::size_t - number of characters written, excluding the null
+ */
+inline std::size_t write_csv(std::span<const latency_result> p_results,
+                             std::span<char> p_buffer)
+{
+  csv_writer csv(p_buffer);
+  csv.append("scenario,min,max,samples\n");
+  for (const auto& result : p_results) {
+    csv.append("%s,%lu,%lu,%lu\n",
+               to_string(result.scenario),
+               static_cast<unsigned long>(result.min),
+               static_cast<unsigned long>(result.max),
+               static_cast<unsigned long>(result.samples));
+  }
+  return csv.size();
+}
+
+/**
+ * @brief Interrupt latency benchmark suite.
+ *
+ * Each scenario is sampled with entry_latency: it reads the DWT cycle counter,
+ * requests an interrupt through the NVIC's STIR and takes the cycle counter
+ * again on the first line of the handler. The results include the store to
+ * STIR and the cycles for the request to reach the core. Scenarios:
+ *
+ * - ram_vector_table: the vector table set up by interrupt::initialize().
+ * - flash_vector_table: VTOR is pointed at a constant table the linker places
+ *   in flash. Every other vector in it forwards to the RAM table.
+ * - fpu_lazy_stacking and fpu_full_stacking: the floating point context is
+ *   made active before the request, with FPCCR.LSPEN set and cleared. Only
+ *   run when compiled for a core with a floating point unit.
+ * - tail_chain: HighIrq and LowIrq are requested while masked by a
+ *   critical_section. Measured from the last line of the HighIrq handler to
+ *   the first line of the LowIrq handler.
+ * - nested_preemption: the LowIrq handler requests HighIrq, which preempts
+ *   it.
+ *
+ * Both IRQs must be unused while measuring. Their priorities are set to
+ * high_priority and low_priority and restored afterwards, and their handlers
+ * are removed. The DWT cycle counter must have been started by constructing a
+ * dwt_counter.
+ *
+ *     using benchmark = latency_benchmark<interrupt_count, 30, 31>;
+ *     std::array<latency_result, latency_scenario_count> results{};
+ *     auto count = benchmark::run(results);
+ *
+ * simulate() computes the same scenarios on nvic_model, so numbers measured
+ * on target can be compared with the expected ones on the host.
+ *
+ * @tparam VectorCount - number of device IRQs, as passed to
+ * interrupt::initialize()
+ * @tparam LowIrq - unused device IRQ for the lower priority handler
+ * @tparam HighIrq - unused device IRQ for the higher priority handler
+ */
+template<std::size_t VectorCount, int LowIrq, int HighIrq>
+class latency_benchmark
+{
+public:
+  static_assert(LowIrq >= 0 && HighIrq >= 0 && LowIrq != HighIrq,
+                "Benchmark IRQs must be two different device IRQs");
+  static_assert(static_cast<std::size_t>(LowIrq) < VectorCount &&
+                  static_cast<std::size_t>(HighIrq) < VectorCount,
+                "Benchmark IRQs must be within the vector table");
+
+  /// Priority of HighIrq while measuring. At or below
+  /// config::zero_latency_threshold in urgency, so critical sections mask it
+  /// for the tail_chain scenario. Multiples of 0x40 are distinct on every core.
+  static constexpr std::uint8_t high_priority =
+    config::zero_latency_threshold <= 0x40
+      ? 0x40
+      : static_cast<std::uint8_t>((config::zero_latency_threshold + 0x3F) &
+                                  0xC0);
+  /// Priority of LowIrq while measuring, one step below HighIrq
+  static constexpr std::uint8_t low_priority =
+    static_cast<std::uint8_t>(high_priority + 0x40);
+
+  static_assert(config::zero_latency_threshold <= 0x80,
+                "config::zero_latency_threshold leaves no room for two "
+                "masked priorities above the lowest");
+
+  /**
+   * @brief Run every scenario supported by the core.
+   *
+   * @param p_results - where to write the results, latency_scenario_count
+   * long is always enough
+   * @param p_samples - number of interrupts to take per scenario
+   * @return boost::leaf::result<std::size_t> - number of results written,
+   * fails with the errors of interrupt::enable()
+   */
+  static boost::leaf::result<std::size_t> run(
+    std::span<latency_result> p_results,
+    std::size_t p_samples = 16)
+  {
+    const auto saved_low = BOOST_LEAF_CHECK(interrupt(LowIrq).get_priority());
+    const auto saved_high = BOOST_LEAF_CHECK(interrupt(HighIrq).get_priority());
+    BOOST_LEAF_CHECK(interrupt(LowIrq).set_priority(low_priority));
+    BOOST_LEAF_CHECK(interrupt(HighIrq).set_priority(high_priority));
+
+    result_recorder<latency_result> results(p_results);
+
+    BOOST_LEAF_CHECK(interrupt(HighIrq).enable(measure_handler));
+    results.record(
+      sample(latency_scenario::ram_vector_table, p_samples, trigger_high));
+
+    system_control control;
+    auto* ram_table = control.get_interrupt_vector_table_address();
+    control.set_interrupt_vector_table_address(
+      const_cast<interrupt_pointer*>(m_flash_table.data()));
+    data_synchronization_barrier();
+    results.record(
+      sample(latency_scenario::flash_vector_table, p_samples, trigger_high));
+    control.set_interrupt_vector_table_address(ram_table);
+    data_synchronization_barrier();
+
+    if constexpr (has_floating_point_unit || embed::is_a_test()) {
+      auto* fpu = system_control::fpu();
+      const std::uint32_t saved_fpccr = fpu->fpccr;
+      fpu->fpccr = saved_fpccr | system_control::fpccr_automatic_save |
+                   system_control::fpccr_lazy_save;
+      results.record(sample(
+        latency_scenario::fpu_lazy_stacking, p_samples, trigger_with_fpu));
+      fpu->fpccr = (saved_fpccr | system_control::fpccr_automatic_save) &
+                   ~system_control::fpccr_lazy_save;
+      results.record(sample(
+        latency_scenario::fpu_full_stacking, p_samples, trigger_with_fpu));
+      fpu->fpccr = saved_fpccr;
+    }
+
+    BOOST_LEAF_CHECK(interrupt(HighIrq).enable(tail_first_handler));
+    BOOST_LEAF_CHECK(interrupt(LowIrq).enable(measure_handler));
+    results.record(
+      sample(latency_scenario::tail_chain, p_samples, trigger_both));
+
+    BOOST_LEAF_CHECK(interrupt(HighIrq).enable(measure_handler));
+    BOOST_LEAF_CHECK(interrupt(LowIrq).enable(preempted_handler));
+    results.record(
+      sample(latency_scenario::nested_preemption, p_samples, trigger_low));
+
+    BOOST_LEAF_CHECK(interrupt(LowIrq).disable());
+    BOOST_LEAF_CHECK(interrupt(HighIrq).disable());
+    BOOST_LEAF_CHECK(interrupt(LowIrq).set_priority(saved_low));
+    BOOST_LEAF_CHECK(interrupt(HighIrq).set_priority(saved_high));
+    return results.size();
+  }
+
+  /**
+   * @brief Compute every scenario on nvic_model instead of the hardware.
+   *
+   * The priorities of LowIrq and HighIrq are set in the (dummy) NVIC
+   * registers the model reads and are left set. Handlers installed for the
+   * IRQs are called as with nvic_model::replay(). Each result is a single
+   * sample.
+   *
+   * @param p_model - timing of the simulated core
+   * @param p_results - where to write the results, at least
+   * latency_scenario_count long
+   * @return std::size_t - number of results written
+   */
+  static std::size_t simulate(const latency_model& p_model,
+                              std::span<latency_result> p_results)
+  {
+    interrupt::nvic()->ip.at(static_cast<std::size_t>(LowIrq)) = low_priority;
+    interrupt::nvic()->ip.at(static_cast<std::size_t>(HighIrq)) =
+      high_priority;
+
+    const std::array<nvic_model::arrival, 1> single{
+      nvic_model::arrival{ .cycle = 0, .irq = HighIrq },
+    };
+    const std::array<nvic_model::arrival, 2> both{
+      nvic_model::arrival{ .cycle = 0, .irq = HighIrq },
+      nvic_model::arrival{ .cycle = 0, .irq = LowIrq },
+    };
+    const std::array<nvic_model::arrival, 2> nested{
+      nvic_model::arrival{ .cycle = 0, .irq = LowIrq },
+      nvic_model::arrival{ .cycle = 50, .irq = HighIrq },
+    };
+
+    auto entry = [&single](std::uint32_t p_entry_cycles) {
+      nvic_model model(p_entry_cycles);
+      const auto completions = model.replay(single);
+      return completions[0].start - completions[0].arrival;
+    };
+    auto tail_chain = [&p_model, &both]() {
+      nvic_model model(p_model.entry_cycles);
+      model.set_tail_chain_cycles(p_model.tail_chain_cycles);
+      model.configure(HighIrq, { .service_cycles = 20, .deadline_cycles = 0 });
+      const auto completions = model.replay(both);
+      return completions[1].start - completions[0].finish;
+    };
+    auto preemption = [&p_model, &nested]() {
+      nvic_model model(p_model.entry_cycles);
+      model.configure(LowIrq, { .service_cycles = 100, .deadline_cycles = 0 });
+      const auto completions = model.replay(nested);
+      return completions[0].start - completions[0].arrival;
+    };
+
+    const std::array<std::pair<latency_scenario, std::uint64_t>,
+                     latency_scenario_count>
+      cycles{ {
+        { latency_scenario::ram_vector_table, entry(p_model.entry_cycles) },
+        { latency_scenario::flash_vector_table,
+          entry(p_model.entry_cycles + p_model.flash_wait_states) },
+        { latency_scenario::fpu_lazy_stacking, entry(p_model.entry_cycles) },
+        { latency_scenario::fpu_full_stacking,
+          entry(p_model.entry_cycles + p_model.fpu_stacking_cycles) },
+        { latency_scenario::tail_chain, tail_chain() },
+        { latency_scenario::nested_preemption, preemption() },
+      } };
+
+    const auto count = std::min(p_results.size(), cycles.size());
+    for (std::size_t i = 0; i < count; i++) {
+      const auto latency = static_cast<std::uint32_t>(cycles[i].second);
+      p_results[i] = latency_result{ .scenario = cycles[i].first,
+                                     .min = latency,
+                                     .max = latency,
+                                     .samples = 1 };
+    }
+    return count;
+  }
+
+private:
+  static constexpr std::size_t table_size =
+    VectorCount + interrupt::core_interrupts;
+
+  /// VTOR requires the table to be aligned to its size rounded up to a power
+  /// of two, and to at least 128 bytes
+  static constexpr std::size_t table_alignment =
+    std::max<std::size_t>(std::bit_ceil(table_size * sizeof(void*)), 128);
+
+  /// Measures every scenario, whichever IRQ's handler calls mark()
+  using probe = entry_latency<HighIrq>;
+
+  template<typename Trigger>
+  static latency_result sample(latency_scenario p_scenario,
+                               std::size_t p_samples,
+                               Trigger p_trigger)
+  {
+    latency_result result{ .scenario = p_scenario,
+                           .min = std::numeric_limits<std::uint32_t>::max(),
+                           .max = 0,
+                           .samples = static_cast<std::uint32_t>(p_samples) };
+    for (std::size_t i = 0; i < p_samples; i++) {
+      const std::uint32_t latency = probe::sample(p_trigger);
+      result.min = std::min(result.min, latency);
+      result.max = std::max(result.max, latency);
+    }
+    return result;
+  }
+
+  static void trigger_high()
+  {
+    probe::start();
+    probe::request(HighIrq);
+  }
+
+  static void trigger_low() { probe::request(LowIrq); }
+
+  static void trigger_with_fpu()
+  {
+#if defined(__ARM_FP)
+    // Any floating point instruction makes the context active (CONTROL.FPCA)
+    asm volatile("vmov.f32 s0, s0" ::: "s0");
+#endif
+    trigger_high();
+  }
+
+  static void trigger_both()
+  {
+    critical_section section;
+    probe::request(HighIrq);
+    probe::request(LowIrq);
+  }
+
+  static void measure_handler() { probe::mark(); }
+
+  static void tail_first_handler() { probe::start(); }
+
+  static void preempted_handler() { trigger_high(); }
+
+  static void forward_handler()
+  {
+    interrupt::get_vector_table()[static_cast<std::size_t>(
+      interrupt::active_irq() + interrupt::core_interrupts)]();
+  }
+
+  static constexpr std::array<interrupt_pointer, table_size> make_flash_table()
+  {
+    std::array<interrupt_pointer, table_size> table{};
+    table.fill(forward_handler);
+    table[HighIrq + interrupt::core_interrupts] = measure_handler;
+    return table;
+  }
+
+  alignas(table_alignment) static constexpr std::array<interrupt_pointer,
+                                                       table_size>
+    m_flash_table = make_flash_table();
+};
+}  // namespace embed::cortex_m
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "critical_section.hpp"
+#include "cycle_cost.hpp"
+#include "seqlock.hpp"
+#include "triple_buffer.hpp"
+
+namespace embed::cortex_m {
+/// Number of operations measured by benchmark_latest_value()
+inline constexpr std::size_t latest_value_operation_count = 5;
+
+/**
+ * @brief Measure the cost of sharing a latest value with seqlock and
+ * triple_buffer, against copying it out inside a critical_section.
+ *
+ * The seqlock and critical_section share four words, such as three readings
+ * and a timestamp. The triple_buffer hands over a 256 byte frame, which costs
+ * the same for any frame size as nothing is copied. Each operation is measured
+ * with fewest_cycles() without contention, which is the common case. The DWT
+ * cycle counter must have been started by constructing a dwt_counter.
+ *
+ * @param p_results - where to write the results, latest_value_operation_count
+ * long is always enough
+ * @param p_samples - number of runs per measurement
+ * @return std::size_t - number of results written
+ */
+inline std::size_t benchmark_latest_value(std::span<operation_cost> p_results,
+                                          std::size_t p_samples = 8)
+{
+  using state = std::array<std::uint32_t, 4>;
+  using frame = std::array<std::uint32_t, 64>;
+  static seqlock<state> shared_state;
+  static triple_buffer<frame> shared_frame;
+  static state guarded_state{};
+  static volatile std::uint32_t sink = 0;
+
+  // Uses every word so that none of the copy is optimized out
+  static constexpr auto consume = [](const state& p_value) {
+    sink = p_value[0] ^ p_value[1] ^ p_value[2] ^ p_value[3];
+  };
+
+  cost_recorder results(p_results);
+  results.record(
+    "seqlock::write",
+    fewest_cycles([]() { shared_state.write(state{ 1, 2, 3, sink }); },
+                  p_samples));
+  results.record(
+    "seqlock::read",
+    fewest_cycles([]() { consume(shared_state.read()); }, p_samples));
+  results.record("triple_buffer::publish",
+                 fewest_cycles(
+                   []() {
+                     shared_frame.write_buffer()[0] = sink;
+                     shared_frame.publish();
+                   },
+                   p_samples));
+  results.record("triple_buffer::update",
+                 fewest_cycles(
+                   []() {
+                     (void)shared_frame.update();
+                     sink = shared_frame.read_buffer()[0];
+                   },
+                   []() { shared_frame.publish(); },
+                   p_samples));
+  results.record("critical_section read",
+                 fewest_cycles(
+                   []() {
+                     critical_section lock;
+                     consume(guarded_state);
+                   },
+                   p_samples));
+  return results.size();
+}
+}  // namespace embed::cortex_m
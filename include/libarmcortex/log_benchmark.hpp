@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+
+#include "cycle_cost.hpp"
+#include "deferred_log.hpp"
+
+namespace embed::cortex_m {
+/// Number of operations measured by benchmark_logging()
+inline constexpr std::size_t log_operation_count = 4;
+
+/**
+ * @brief Measure the cost of logging with LIBARMCORTEX_LOG, against
+ * formatting the same message on the target with snprintf.
+ *
+ * Each operation is measured with fewest_cycles() on an empty deferred_log,
+ * so no record is dropped. The DWT cycle counter must have been started by
+ * constructing a dwt_counter.
+ *
+ * @param p_results - where to write the results, log_operation_count long is
+ * always enough
+ * @param p_samples - number of runs per measurement
+ * @return std::size_t - number of results written
+ */
+inline std::size_t benchmark_logging(std::span<operation_cost> p_results,
+                                     std::size_t p_samples = 8)
+{
+  static deferred_log<64> log;
+  static std::array<std::uint32_t, 64> drained{};
+  static std::array<char, 64> text{};
+  // Keeps the arguments from being folded into constants
+  static volatile std::int32_t argument = 1234;
+
+  cost_recorder results(p_results);
+  auto drain = []() { (void)log.read(drained); };
+
+  results.record(
+    "LIBARMCORTEX_LOG no arguments",
+    fewest_cycles(
+      []() { LIBARMCORTEX_LOG(log, "started"); }, drain, p_samples));
+  results.record("LIBARMCORTEX_LOG 2 arguments",
+                 fewest_cycles(
+                   []() {
+                     const std::int32_t value = argument;
+                     LIBARMCORTEX_LOG(log, "adc %d = %d", value, value);
+                   },
+                   drain,
+                   p_samples));
+  results.record("LIBARMCORTEX_LOG 4 arguments",
+                 fewest_cycles(
+                   []() {
+                     const std::int32_t value = argument;
+                     LIBARMCORTEX_LOG(log,
+                                      "adc %d = %d (%d..%d)",
+                                      value,
+                                      value,
+                                      value,
+                                      value);
+                   },
+                   drain,
+                   p_samples));
+  results.record("snprintf 2 arguments",
+                 fewest_cycles(
+                   []() {
+                     const std::int32_t value = argument;
+                     std::snprintf(
+                       text.data(), text.size(), "adc %d = %d", value, value);
+                   },
+                   p_samples));
+  drain();
+  return results.size();
+}
+}  // namespace embed::cortex_m
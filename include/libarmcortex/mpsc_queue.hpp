@@ -0,0 +1,214 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <type_traits>
+
+#include "atomic.hpp"
+#include "system_control.hpp"
+
+namespace embed::cortex_m {
+/**
+ * @brief Lock-free multiple producer single consumer fixed capacity queue
+ *
+ * Intended for cases where several interrupt service routines (potentially at
+ * different priorities) and/or threads feed a single consumer, such as the
+ * main loop.
+ *
+ * Producers reserve space by advancing a shared index with compare-and-swap,
+ * which is implemented with LDREX/STREX on ARMv7-M and above. If a producer is
+ * preempted between loading and storing the index, the exclusive monitor is
+ * cleared on exception entry and the store simply retries, so no producer ever
+ * waits on another and interrupts are never disabled. On ARMv6-M the
+ * compare-and-swap falls back to a critical section a few instructions long,
+ * see cortex_m::atomic.
+ *
+ * Because a reservation and the publishing of the data are separate steps, a
+ * producer that is preempted after reserving a slot holds back every slot
+ * reserved after it until it resumes and publishes. The consumer observes
+ * this as the queue being momentarily empty (or shorter than expected), never
+ * as corrupt data.
+ *
+ * @tparam T - trivially copyable element type
+ * @tparam Capacity - number of elements, must be a power of two
+ */
+template<typename T, std::size_t Capacity>
+class mpsc_queue
+{
+public:
+  static_assert(std::has_single_bit(Capacity),
+                "mpsc_queue Capacity must be a power of two");
+  static_assert(Capacity <= (std::size_t{ 1 } << 31U),
+                "mpsc_queue Capacity must fit within the 32-bit index space");
+  static_assert(std::is_trivially_copyable_v<T>,
+                "mpsc_queue elements must be trivially copyable");
+
+  /// Mask used to convert a free running index into a buffer position
+  static constexpr auto mask = static_cast<std::uint32_t>(Capacity - 1);
+
+  /**
+   * @brief Push a single element into the queue. Safe to call from any number
+   * of producers concurrently.
+   *
+   * @param p_value - element to push
+   * @return true - element was pushed
+   * @return false - the queue is full and the element was dropped
+   */
+  [[nodiscard]] bool push(const T& p_value) noexcept
+  {
+    return push(std::span<const T>(&p_value, 1)) == 1;
+  }
+
+  /**
+   * @brief Push as many elements from the span as will fit. Safe to call from
+   * any number of producers concurrently.
+   *
+   * All of the pushed elements are reserved with a single compare-and-swap and
+   * are guaranteed to be contiguous in the queue, meaning that they will not be
+   * interleaved with elements from other producers.
+   *
+   * @param p_values - elements to push
+   * @return std::size_t - number of elements pushed
+   */
+  [[nodiscard]] std::size_t push(std::span<const T> p_values) noexcept
+  {
+    return write(p_values, true);
+  }
+
+  /**
+   * @brief Push every element from the span or none of them. Safe to call from
+   * any number of producers concurrently.
+   *
+   * Useful for variable length records that must not be truncated, as the
+   * elements are contiguous in the queue just like with push().
+   *
+   * @param p_values - elements to push
+   * @return true - all elements were pushed
+   * @return false - there was not enough room, nothing was pushed
+   */
+  [[nodiscard]] bool push_all(std::span<const T> p_values) noexcept
+  {
+    return write(p_values, false) == p_values.size();
+  }
+
+  /**
+   * @brief Pop a single element from the queue. Must only be called by the
+   * consumer.
+   *
+   * @return std::optional<T> - the oldest element or std::nullopt if the queue
+   * is empty or the oldest element has not been published yet.
+   */
+  [[nodiscard]] std::optional<T> pop() noexcept
+  {
+    T value{};
+    if (pop(std::span<T>(&value, 1)) == 0) {
+      return std::nullopt;
+    }
+    return value;
+  }
+
+  /**
+   * @brief Pop as many published elements as are available into the span.
+   * Must only be called by the consumer.
+   *
+   * Stops at the first element that has been reserved by a producer but has
+   * not yet been published.
+   *
+   * @param p_destination - location to copy the popped elements to
+   * @return std::size_t - number of elements popped
+   */
+  [[nodiscard]] std::size_t pop(std::span<T> p_destination) noexcept
+  {
+    const auto head = m_head.load(std::memory_order_relaxed);
+    std::uint32_t count = 0;
+
+    while (count < p_destination.size()) {
+      const auto position = head + count;
+      auto& slot = m_slots[position & mask];
+      if (slot.sequence.load(std::memory_order_acquire) != position + 1) {
+        break;
+      }
+      p_destination[count] = slot.value;
+      count++;
+    }
+
+    m_head.store(head + count, std::memory_order_release);
+    return count;
+  }
+
+  /**
+   * @return std::size_t - number of elements reserved in the queue at the time
+   * of the call. This includes elements that have not yet been published.
+   */
+  [[nodiscard]] std::size_t size() const noexcept
+  {
+    // Load the consumer index first so that the producer index can only be
+    // further ahead of it, never behind.
+    const auto head = m_head.load(std::memory_order_acquire);
+    return m_tail.load(std::memory_order_acquire) - head;
+  }
+
+  /// @return true - if the queue held no elements at the time of the call
+  [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+  /// @return constexpr std::size_t - the capacity of the queue
+  [[nodiscard]] static constexpr std::size_t capacity() noexcept
+  {
+    return Capacity;
+  }
+
+private:
+  std::size_t write(std::span<const T> p_values, bool p_partial) noexcept
+  {
+    auto tail = m_tail.load(std::memory_order_relaxed);
+    std::uint32_t count = 0;
+
+    do {
+      const auto head = m_head.load(std::memory_order_acquire);
+      const auto available =
+        static_cast<std::uint32_t>(Capacity) - (tail - head);
+      if (!p_partial && p_values.size() > available) {
+        return 0;
+      }
+      count = static_cast<std::uint32_t>(
+        std::min<std::size_t>(p_values.size(), available));
+
+      if (count == 0) {
+        return 0;
+      }
+    } while (!m_tail.compare_exchange_weak(tail,
+                                           tail + count,
+                                           std::memory_order_relaxed,
+                                           std::memory_order_relaxed));
+
+    for (std::uint32_t i = 0; i < count; i++) {
+      auto& slot = m_slots[(tail + i) & mask];
+      slot.value = p_values[i];
+      slot.sequence.store(tail + i + 1, std::memory_order_release);
+    }
+
+    return count;
+  }
+
+  struct slot_t
+  {
+    /// Set to position + 1 once the element for a position is published
+    std::atomic<std::uint32_t> sequence{};
+    T value{};
+  };
+
+  /// Consumer index, only written by the consumer
+  alignas(system_control::cache_line_size) std::atomic<std::uint32_t> m_head{};
+  /// Reservation index, shared by all producers
+  alignas(system_control::cache_line_size) atomic<std::uint32_t> m_tail{};
+  /// Element storage, kept off of the lines holding the indices
+  alignas(system_control::cache_line_size)
+    std::array<slot_t, Capacity> m_slots{};
+};
+}  // namespace embed::cortex_m
@@ -0,0 +1,411 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "dwt_counter.hpp"
+#include "interrupt.hpp"
+#include "system_control.hpp"
+#include "trace.hpp"
+
+namespace embed::cortex_m {
+/**
+ * @brief Host side model of the NVIC used to replay recorded interrupt
+ * timelines against the firmware's own interrupt handlers.
+ *
+ * The model is a discrete event simulation in CPU cycles. Interrupt arrivals
+ * set a pending bit, and the highest priority pending interrupt (lowest
+ * priority value, then lowest IRQ number) is taken if it preempts whatever is
+ * running. Priorities are read from the (dummy) NVIC `ip` and SCB `shp`
+ * registers, so the firmware's own priority setup is used. Like the hardware,
+ * an interrupt that arrives while it is already pending is coalesced into the
+ * pending one and counted as lost.
+ *
+ * When an interrupt is taken, the handler installed in
+ * interrupt::vector_table is called with the DWT cycle counter set to the
+ * simulated time and the ICSR active vector set, so handlers observe the same
+ * timestamps and interrupt::active_irq() as on target. Handlers execute
+ * instantly on the host, so each IRQ is given a modeled service time in
+ * cycles, during which it can be preempted by higher priority arrivals. The
+ * side effects of a handler all happen at the start of that window.
+ *
+ * Interrupt masking, such as critical sections in thread mode, is modeled with
+ * mask(). This can be used to check that zero latency interrupts (see
+ * interrupt::basic_zero_latency) are never held off by the library.
+ *
+ * The resulting per interrupt latencies, response times and deadline misses
+ * are deterministic for a given timeline and configuration, so they can be
+ * compared across firmware versions.
+ */
+class nvic_model
+{
+public:
+  /// An interrupt request arriving at the NVIC
+  struct arrival
+  {
+    /// Time of arrival in CPU cycles
+    std::uint64_t cycle;
+    /// IRQ number
+    int irq;
+  };
+
+  /// Modeled behavior of an interrupt's service routine
+  struct irq_config
+  {
+    /// Cycles spent in the handler, excluding entry
+    std::uint32_t service_cycles;
+    /// Maximum allowed cycles from arrival to handler return, 0 for none
+    std::uint32_t deadline_cycles;
+  };
+
+  /// Timeline of a single serviced interrupt
+  struct completion
+  {
+    /// IRQ number
+    int irq;
+    /// Cycle the request arrived
+    std::uint64_t arrival;
+    /// Cycle the handler started executing
+    std::uint64_t start;
+    /// Cycle the handler returned
+    std::uint64_t finish;
+  };
+
+  /// A span of time during which interrupts are masked, such as a
+  /// critical_section in thread mode or a lower priority handler
+  struct masking_window
+  {
+    /// First cycle interrupts are masked
+    std::uint64_t start;
+    /// Cycle interrupts are unmasked again
+    std::uint64_t end;
+    /// Interrupts with a priority value at or above this are masked, as with
+    /// BASEPRI. 0 masks every configurable interrupt, as with PRIMASK.
+    std::uint8_t basepri;
+  };
+
+  /// Accumulated statistics for a single interrupt
+  struct irq_statistics
+  {
+    /// Number of times the handler ran
+    std::uint32_t count;
+    /// Number of arrivals coalesced into an already pending request
+    std::uint32_t lost;
+    /// Number of times the response time exceeded the deadline
+    std::uint32_t deadline_misses;
+    /// Worst case cycles from arrival to handler start
+    std::uint64_t max_latency;
+    /// Worst case cycles from arrival to handler return
+    std::uint64_t max_response;
+  };
+
+  /// Number of vectors modeled, the maximum the NVIC supports
+  static constexpr std::size_t vector_count = 256;
+
+  /**
+   * @brief Construct a new nvic model object
+   *
+   * @param p_entry_cycles - cycles from an interrupt being taken to the first
+   * instruction of its handler (12 on Cortex-M3/M4 with zero wait state memory)
+   */
+  explicit nvic_model(std::uint32_t p_entry_cycles = 12)
+    : m_entry_cycles(p_entry_cycles)
+    , m_tail_chain_cycles(p_entry_cycles)
+  {}
+
+  /**
+   * @brief Set the cycles to take an interrupt that is pending when a handler
+   * returns.
+   *
+   * The hardware skips unstacking and restacking the context in this case
+   * (tail-chaining), which takes 6 cycles on Cortex-M3/M4. Defaults to the
+   * entry cycles.
+   *
+   * @param p_cycles - cycles from a handler returning to the first
+   * instruction of the next handler
+   */
+  void set_tail_chain_cycles(std::uint32_t p_cycles)
+  {
+    m_tail_chain_cycles = p_cycles;
+  }
+
+  /**
+   * @brief Set the modeled behavior of an interrupt
+   *
+   * @param p_irq - IRQ number
+   * @param p_config - service time and deadline
+   */
+  void configure(int p_irq, irq_config p_config)
+  {
+    m_config.at(vector(p_irq)) = p_config;
+  }
+
+  /**
+   * @brief Get the priority of an interrupt as programmed in the NVIC and SCB
+   *
+   * @param p_irq - IRQ number
+   * @return int - priority, lower values preempt higher values. NMI and
+   * HardFault have the fixed priorities -2 and -1.
+   */
+  static int priority(int p_irq)
+  {
+    static constexpr int first_configurable = -12;
+    if (p_irq >= 0) {
+      return interrupt::nvic()->ip.at(static_cast<std::size_t>(p_irq));
+    }
+    if (p_irq >= first_configurable) {
+      return system_control::scb()->shp.at(
+        static_cast<std::size_t>(p_irq - first_configurable));
+    }
+    return p_irq - first_configurable;
+  }
+
+  /**
+   * @brief Mask interrupts over a span of time.
+   *
+   * A pending interrupt that is masked is taken as soon as the window ends,
+   * which models the latency that critical sections add. NMI and HardFault
+   * are never masked.
+   *
+   * @param p_window - time span and masking level
+   */
+  void mask(masking_window p_window) { m_masking.push_back(p_window); }
+
+  /**
+   * @brief Inject a timeline of arrivals and run the simulation to completion
+   *
+   * Statistics accumulate across calls to replay().
+   *
+   * @param p_arrivals - arrivals sorted by cycle
+   * @return std::vector<completion> - every serviced interrupt in the order
+   * the handlers returned
+   */
+  std::vector<completion> replay(std::span<const arrival> p_arrivals)
+  {
+    std::vector<completion> completions;
+    std::vector<frame> active;
+    std::size_t next = 0;
+    std::uint64_t now = p_arrivals.empty() ? 0 : p_arrivals.front().cycle;
+    std::optional<std::uint64_t> returned_at;
+
+    while (next < p_arrivals.size() || !active.empty() || any_pending()) {
+      // Latch every arrival that has happened by now
+      while (next < p_arrivals.size() && p_arrivals[next].cycle <= now) {
+        latch(p_arrivals[next]);
+        next++;
+      }
+
+      // Take the highest priority pending interrupt if it preempts
+      const auto candidate = highest_pending();
+      if (candidate && !masked(*candidate, now) &&
+          (active.empty() ||
+           priority(*candidate) < priority(active.back().irq))) {
+        const auto index = vector(*candidate);
+        const auto arrived = *m_pending[index];
+        m_pending[index].reset();
+        now += returned_at == now ? m_tail_chain_cycles : m_entry_cycles;
+        active.push_back(frame{ .irq = *candidate,
+                                .arrival = arrived,
+                                .start = now,
+                                .remaining = m_config[index].service_cycles });
+        run_handler(*candidate, now);
+        restore_active_vector(active);
+        continue;
+      }
+
+      const auto next_arrival = next < p_arrivals.size()
+                                  ? p_arrivals[next].cycle
+                                  : std::uint64_t{ UINT64_MAX };
+      const auto next_event = std::min(next_arrival, next_unmask(now));
+      if (active.empty()) {
+        now = next_event;
+        continue;
+      }
+
+      // Run the active handler until it returns or the next event
+      auto& running = active.back();
+      const auto budget = next_event - now;
+      if (running.remaining <= budget) {
+        now += running.remaining;
+        record(running, now, completions);
+        returned_at = now;
+        active.pop_back();
+        restore_active_vector(active);
+      } else {
+        running.remaining -= budget;
+        now = next_event;
+      }
+    }
+    return completions;
+  }
+
+  /**
+   * @param p_irq - IRQ number
+   * @return const irq_statistics& - statistics accumulated for the interrupt
+   */
+  [[nodiscard]] const irq_statistics& statistics(int p_irq) const
+  {
+    return m_statistics.at(vector(p_irq));
+  }
+
+  /// @return std::size_t - most interrupts that were pending at the same time
+  [[nodiscard]] std::size_t max_pending() const { return m_max_pending; }
+
+  /**
+   * @brief Extract the arrival timeline from a trace dump recorded on target
+   * with basic_trace installed as an interrupt::trampoline hook.
+   *
+   * The IRQ enter events are used as arrival times and the 32-bit cycle count
+   * is unwrapped. Entry times on target include any time spent pending behind
+   * higher priority interrupts, so the replayed latencies are a lower bound
+   * when the trace was recorded under load.
+   *
+   * @param p_events - events from basic_trace::snapshot(), oldest first
+   * @return std::vector<arrival> - arrivals sorted by cycle
+   */
+  static std::vector<arrival> arrivals_from_trace(
+    std::span<const trace_event> p_events)
+  {
+    std::vector<arrival> arrivals;
+    std::uint64_t cycle = 0;
+    std::uint32_t previous = p_events.empty() ? 0 : p_events[0].cycle_count;
+    for (const auto& event : p_events) {
+      cycle += event.cycle_count - previous;
+      previous = event.cycle_count;
+      if (event.type == trace_event_type::irq_enter) {
+        arrivals.push_back({ .cycle = cycle, .irq = event.id });
+      }
+    }
+    return arrivals;
+  }
+
+private:
+  struct frame
+  {
+    int irq;
+    std::uint64_t arrival;
+    std::uint64_t start;
+    std::uint64_t remaining;
+  };
+
+  static std::size_t vector(int p_irq)
+  {
+    return static_cast<std::size_t>(p_irq + interrupt::core_interrupts);
+  }
+
+  void latch(const arrival& p_arrival)
+  {
+    auto& pending = m_pending.at(vector(p_arrival.irq));
+    if (pending) {
+      m_statistics[vector(p_arrival.irq)].lost++;
+      return;
+    }
+    pending = p_arrival.cycle;
+    const auto count = static_cast<std::size_t>(
+      std::count_if(m_pending.begin(), m_pending.end(), [](const auto& p) {
+        return p.has_value();
+      }));
+    m_max_pending = std::max(m_max_pending, count);
+  }
+
+  [[nodiscard]] bool any_pending() const
+  {
+    return std::any_of(m_pending.begin(), m_pending.end(), [](const auto& p) {
+      return p.has_value();
+    });
+  }
+
+  [[nodiscard]] std::optional<int> highest_pending() const
+  {
+    std::optional<int> highest;
+    for (std::size_t i = 0; i < m_pending.size(); i++) {
+      if (!m_pending[i]) {
+        continue;
+      }
+      const int irq = static_cast<int>(i) - interrupt::core_interrupts;
+      if (!highest || priority(irq) < priority(*highest)) {
+        highest = irq;
+      }
+    }
+    return highest;
+  }
+
+  [[nodiscard]] bool masked(int p_irq, std::uint64_t p_now) const
+  {
+    static constexpr int first_configurable = -12;
+    if (p_irq < first_configurable) {
+      return false;
+    }
+    const auto level = priority(p_irq);
+    return std::any_of(
+      m_masking.begin(), m_masking.end(), [=](const masking_window& p_window) {
+        return p_window.start <= p_now && p_now < p_window.end &&
+               (p_window.basepri == 0 || level >= p_window.basepri);
+      });
+  }
+
+  /// @return std::uint64_t - earliest end of a window masking at p_now
+  [[nodiscard]] std::uint64_t next_unmask(std::uint64_t p_now) const
+  {
+    std::uint64_t earliest = UINT64_MAX;
+    for (const auto& window : m_masking) {
+      if (window.start <= p_now && p_now < window.end) {
+        earliest = std::min(earliest, window.end);
+      }
+    }
+    return earliest;
+  }
+
+  void record(const frame& p_frame,
+              std::uint64_t p_now,
+              std::vector<completion>& p_completions)
+  {
+    auto& statistics = m_statistics[vector(p_frame.irq)];
+    const auto latency = p_frame.start - p_frame.arrival;
+    const auto response = p_now - p_frame.arrival;
+    const auto deadline = m_config[vector(p_frame.irq)].deadline_cycles;
+
+    statistics.count++;
+    statistics.max_latency = std::max(statistics.max_latency, latency);
+    statistics.max_response = std::max(statistics.max_response, response);
+    if (deadline != 0 && response > deadline) {
+      statistics.deadline_misses++;
+    }
+    p_completions.push_back({ .irq = p_frame.irq,
+                              .arrival = p_frame.arrival,
+                              .start = p_frame.start,
+                              .finish = p_now });
+  }
+
+  static void run_handler(int p_irq, std::uint64_t p_now)
+  {
+    dwt_counter::dwt()->cyccnt = static_cast<std::uint32_t>(p_now);
+    system_control::scb()->icsr = static_cast<std::uint32_t>(vector(p_irq));
+    const auto index = vector(p_irq);
+    if (index < interrupt::vector_table.size()) {
+      interrupt::vector_table[index]();
+    }
+  }
+
+  static void restore_active_vector(const std::vector<frame>& p_active)
+  {
+    system_control::scb()->icsr =
+      p_active.empty()
+        ? 0U
+        : static_cast<std::uint32_t>(vector(p_active.back().irq));
+  }
+
+  std::uint32_t m_entry_cycles;
+  std::uint32_t m_tail_chain_cycles;
+  std::array<irq_config, vector_count> m_config{};
+  std::array<irq_statistics, vector_count> m_statistics{};
+  std::array<std::optional<std::uint64_t>, vector_count> m_pending{};
+  std::vector<masking_window> m_masking{};
+  std::size_t m_max_pending = 0;
+};
+}  // namespace embed::cortex_m
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "cycle_cost.hpp"
+#include "mpsc_queue.hpp"
+#include "spsc_queue.hpp"
+
+namespace embed::cortex_m {
+/// Number of operations measured by benchmark_queues()
+inline constexpr std::size_t queue_operation_count = 8;
+
+/// Number of elements moved by the batch operations of benchmark_queues()
+inline constexpr std::size_t queue_batch_size = 8;
+
+/**
+ * @brief Measure push and pop on spsc_queue and mpsc_queue, one element at a
+ * time and in batches of queue_batch_size, with 32-bit elements.
+ *
+ * Each operation is measured with fewest_cycles() on a queue emptied, or
+ * filled with just enough elements, before every run so that each run does
+ * the same work. Interrupts are left as they are, so run with the ones that
+ * use the queues disabled. The DWT cycle counter must have been started by
+ * constructing a dwt_counter.
+ *
+ * @param p_results - where to write the results, queue_operation_count long
+ * is always enough
+ * @param p_samples - number of runs per measurement
+ * @return std::size_t - number of results written
+ */
+inline std::size_t benchmark_queues(std::span<operation_cost> p_results,
+                                    std::size_t p_samples = 8)
+{
+  using element = std::uint32_t;
+  static spsc_queue<element, queue_batch_size * 2> spsc;
+  static mpsc_queue<element, queue_batch_size * 2> mpsc;
+  static std::array<element, queue_batch_size> batch{};
+
+  cost_recorder results(p_results);
+  auto measure_queue = [&results, p_samples](auto& p_queue,
+                                             const char* p_push,
+                                             const char* p_pop,
+                                             const char* p_push_batch,
+                                             const char* p_pop_batch) {
+    auto drain = [&p_queue]() { (void)p_queue.pop(batch); };
+    auto fill_one = [&p_queue, drain]() {
+      drain();
+      (void)p_queue.push(element{ 1 });
+    };
+    auto fill_batch = [&p_queue, drain]() {
+      drain();
+      (void)p_queue.push(std::span<const element>(batch));
+    };
+
+    results.record(
+      p_push,
+      fewest_cycles([&p_queue]() { (void)p_queue.push(element{ 1 }); },
+                    drain,
+                    p_samples));
+    results.record(
+      p_pop,
+      fewest_cycles(
+        [&p_queue]() { (void)p_queue.pop(); }, fill_one, p_samples));
+    results.record(
+      p_push_batch,
+      fewest_cycles(
+        [&p_queue]() { (void)p_queue.push(std::span<const element>(batch)); },
+        drain,
+        p_samples));
+    results.record(
+      p_pop_batch,
+      fewest_cycles(
+        [&p_queue]() { (void)p_queue.pop(batch); }, fill_batch, p_samples));
+    drain();
+  };
+
+  measure_queue(spsc,
+                "spsc_queue::push",
+                "spsc_queue::pop",
+                "spsc_queue::push batch",
+                "spsc_queue::pop batch");
+  measure_queue(mpsc,
+                "mpsc_queue::push",
+                "mpsc_queue::pop",
+                "mpsc_queue::push batch",
+                "mpsc_queue::pop batch");
+  return results.size();
+}
+}  // namespace embed::cortex_m
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include <libembeddedhal/error.hpp>
+
+#include "coroutine_executor.hpp"
+#include "entry_latency.hpp"
+
+namespace embed::cortex_m {
+/**
+ * @brief Measures the cycles from an interrupt being requested to the first
+ * line of a coroutine awaiting it with coroutine_executor::irq_event.
+ *
+ * Uses entry_latency's building blocks: each sample reads the DWT cycle
+ * counter immediately before a raw store of the IRQ to STIR, and the
+ * coroutine calls mark() as soon as it resumes. The result includes exception
+ * entry, coroutine_executor::irq_trampoline making the coroutine ready, the
+ * exception return, popping the ready queue in run_once() and resuming the
+ * coroutine. Compare it against entry_latency to see what moving work out of
+ * the handler costs. The minimum over the samples is reported.
+ *
+ * The executor must have been initialized with a free frame, and nothing else
+ * may use the IRQ while measuring. Other coroutines that become ready are run
+ * between samples. The DWT cycle counter must have been started by
+ * constructing a dwt_counter.
+ *
+ *     auto latency = resume_latency<spare_irq>::measure();
+ *
+ * @tparam Irq - unused device IRQ to measure with
+ */
+template<int Irq>
+class resume_latency
+{
+public:
+  /**
+   * @brief Error indicating that the coroutine used to measure could not be
+   * created or could not wait on the IRQ.
+   *
+   */
+  struct coroutine_unavailable
+  {
+    /// IRQ being measured
+    int irq;
+  };
+
+  /**
+   * @brief Measure the resume latency of a coroutine awaiting the IRQ.
+   *
+   * @param p_samples - number of times to take the interrupt
+   * @return boost::leaf::result<std::uint32_t> - fewest cycles from the
+   * request to the coroutine resuming, fails with coroutine_unavailable if
+   * the executor has no free frame, the IRQ is invalid or too many coroutines
+   * are waiting on interrupts.
+   */
+  static boost::leaf::result<std::uint32_t> measure(std::size_t p_samples = 16)
+  {
+    m_failed = false;
+    if (!coroutine_executor::spawn(waiter(p_samples))) {
+      return boost::leaf::new_error(coroutine_unavailable{ .irq = Irq });
+    }
+    // Run the coroutine up to its first co_await
+    while (coroutine_executor::run_once()) {
+      continue;
+    }
+    if (m_failed) {
+      return boost::leaf::new_error(coroutine_unavailable{ .irq = Irq });
+    }
+
+    std::uint32_t fewest = std::numeric_limits<std::uint32_t>::max();
+    for (std::size_t i = 0; i < p_samples; i++) {
+      const auto cycles = probe::sample([]() {
+        m_resumed = false;
+        probe::start();
+        probe::request();
+        while (!m_resumed) {
+          (void)coroutine_executor::run_once();
+        }
+      });
+      fewest = cycles < fewest ? cycles : fewest;
+    }
+    return fewest;
+  }
+
+private:
+  using probe = entry_latency<Irq>;
+
+  /// Awaits the IRQ p_samples times, then returns and frees its frame
+  static coroutine_executor::task waiter(std::size_t p_samples)
+  {
+    for (std::size_t i = 0; i < p_samples; i++) {
+      if (!co_await coroutine_executor::irq_event(Irq)) {
+        m_failed = true;
+        co_return;
+      }
+      probe::mark();
+      m_resumed = true;
+    }
+  }
+
+  static inline volatile bool m_resumed = false;
+  static inline volatile bool m_failed = false;
+};
+}  // namespace embed::cortex_m
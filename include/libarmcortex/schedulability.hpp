@@ -0,0 +1,293 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include <libembeddedhal/error.hpp>
+
+#include "atomic.hpp"
+#include "dwt_counter.hpp"
+#include "interrupt.hpp"
+
+namespace embed::cortex_m {
+/// Declared arrival pattern and deadline of an interrupt
+struct irq_timing
+{
+  /// IRQ number
+  int irq;
+  /// Period or minimum time between two arrivals, in CPU cycles
+  std::uint32_t min_interarrival;
+  /// Most cycles allowed from arrival to handler return, 0 to use
+  /// min_interarrival
+  std::uint32_t deadline;
+};
+
+/// Everything the response time analysis needs to know about an interrupt
+struct irq_profile
+{
+  /// IRQ number
+  int irq;
+  /// NVIC priority value, lower values preempt higher values
+  std::uint8_t priority;
+  /// Period or minimum time between two arrivals, in CPU cycles
+  std::uint32_t min_interarrival;
+  /// Most cycles allowed from arrival to handler return, 0 to use
+  /// min_interarrival
+  std::uint32_t deadline;
+  /// Worst case execution cycles of the handler
+  std::uint32_t wcet;
+};
+
+/// Outcome of the response time analysis for one interrupt
+struct irq_response
+{
+  /// IRQ number
+  int irq;
+  /// Worst case cycles from arrival to handler return, or the first value
+  /// found past the deadline if unschedulable
+  std::uint64_t response;
+  /// Deadline minus response, negative when the deadline can be missed
+  std::int64_t slack;
+  /// The interrupt always meets its deadline
+  bool schedulable;
+};
+
+/**
+ * @brief interrupt::trampoline hook that measures the worst case execution
+ * time of each interrupt handler with the DWT cycle counter.
+ *
+ * Time spent in nested handlers that are also wrapped by this hook is
+ * subtracted, so the recorded times are the handlers' own execution times, as
+ * response time analysis expects. Preemption by handlers that are not wrapped
+ * is counted as execution time, which overestimates. Entry and exit take a
+ * few loads and stores each.
+ *
+ *     using wcet = wcet_monitor<42>;
+ *     interrupt(irq).enable(interrupt::trampoline<handler, wcet>);
+ *
+ * The DWT cycle counter must have been started by constructing a dwt_counter.
+ *
+ * @tparam IrqCount - number of device IRQs, as passed to
+ * interrupt::initialize()
+ * @tparam MaxNesting - most wrapped handlers that can be nested
+ */
+template<std::size_t IrqCount, std::size_t MaxNesting = 8>
+class wcet_monitor
+{
+public:
+  /// interrupt::trampoline hook, records when the handler started
+  static void enter([[maybe_unused]] int p_irq) noexcept
+  {
+    // Claim the slot before filling it, so a nested handler that preempts in
+    // between uses the next one.
+    const auto depth = m_depth.load(std::memory_order_relaxed);
+    m_depth.store(depth + 1, std::memory_order_relaxed);
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    if (depth < MaxNesting) {
+      m_start[depth] = dwt_counter::dwt()->cyccnt;
+      m_preempted[depth] = 0;
+    }
+  }
+
+  /// interrupt::trampoline hook, records the handler's execution time
+  static void exit(int p_irq) noexcept
+  {
+    const std::uint32_t now = dwt_counter::dwt()->cyccnt;
+    const auto depth = m_depth.load(std::memory_order_relaxed) - 1;
+    if (depth < MaxNesting) {
+      const std::uint32_t total = now - m_start[depth];
+      const std::uint32_t own = total - m_preempted[depth];
+      if (depth > 0) {
+        m_preempted[depth - 1] += total;
+      }
+      const auto index = static_cast<std::size_t>(p_irq + core_interrupts);
+      if (index < m_wcet.size() && own > m_wcet[index]) {
+        m_wcet[index] = own;
+      }
+    }
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    m_depth.store(depth, std::memory_order_relaxed);
+  }
+
+  /**
+   * @param p_irq - IRQ number
+   * @return std::uint32_t - most cycles the handler has taken, 0 if it has
+   * not run
+   */
+  static std::uint32_t wcet(int p_irq) noexcept
+  {
+    const auto index = static_cast<std::size_t>(p_irq + core_interrupts);
+    return index < m_wcet.size() ? m_wcet[index] : 0;
+  }
+
+  /// Forget every measurement
+  static void reset() noexcept { m_wcet.fill(0); }
+
+  /**
+   * @brief Combine declared timing with the programmed priorities and the
+   * measured execution times.
+   *
+   * @param p_timing - declared timing of each interrupt
+   * @param p_profiles - where to write the profiles, at least as long as
+   * p_timing
+   * @return boost::leaf::result<void> - errors of interrupt::get_priority()
+   */
+  static boost::leaf::result<void> profile(std::span<const irq_timing> p_timing,
+                                           std::span<irq_profile> p_profiles)
+  {
+    for (std::size_t i = 0; i < p_timing.size(); i++) {
+      const auto& timing = p_timing[i];
+      const auto priority =
+        BOOST_LEAF_CHECK(interrupt(timing.irq).get_priority());
+      p_profiles[i] = irq_profile{ .irq = timing.irq,
+                                   .priority = priority,
+                                   .min_interarrival = timing.min_interarrival,
+                                   .deadline = timing.deadline,
+                                   .wcet = wcet(timing.irq) };
+    }
+    return {};
+  }
+
+private:
+  static constexpr int core_interrupts = interrupt::core_interrupts;
+
+  static inline std::array<std::uint32_t, MaxNesting> m_start{};
+  static inline std::array<std::uint32_t, MaxNesting> m_preempted{};
+  static inline std::array<std::uint32_t, IrqCount + core_interrupts> m_wcet{};
+  static inline atomic<std::uint32_t> m_depth{ 0 };
+};
+
+/**
+ * @brief Fixed priority response time analysis of a set of interrupts.
+ *
+ * The worst case response time of each interrupt is the smallest fixed point
+ * of R = C + B + sum(ceil(R / T) * C) over the interrupts that can preempt it,
+ * where C is the execution time plus p_overhead, T the minimum interarrival
+ * time and B the longest execution time of an interrupt in the same priority
+ * group that the NVIC takes after it, which cannot preempt it but can be
+ * running when it arrives.
+ *
+ * Only the group priority selected by AIRCR.PRIGROUP decides preemption, so
+ * priorities are compared through p_group_mask. Within a group the NVIC takes
+ * the lowest subpriority and then the lowest IRQ number first, so those taken
+ * first are counted as preempting, which is slightly pessimistic. Lower
+ * priority groups are preempted and never delay it. Thread mode critical
+ * sections are not included.
+ *
+ * @param p_profiles - the interrupts to analyze
+ * @param p_responses - where to write the result for each interrupt, at least
+ * as long as p_profiles
+ * @param p_overhead - cycles added to every execution for exception entry and
+ * exit, about 24 on Cortex M3/M4 with zero wait state memory
+ * @param p_group_mask - group priority bits, as returned by
+ * system_control::priority_group_mask() on the target. The default is that of
+ * PRIGROUP's reset value of 0.
+ * @return true - every interrupt always meets its deadline
+ */
+inline bool response_time_analysis(std::span<const irq_profile> p_profiles,
+                                   std::span<irq_response> p_responses,
+                                   std::uint32_t p_overhead = 0,
+                                   std::uint8_t p_group_mask = 0xFE)
+{
+  auto group = [p_group_mask](const irq_profile& p_irq) {
+    return p_irq.priority & p_group_mask;
+  };
+  // Order the NVIC takes pending interrupts of the same group in
+  auto taken_first = [](const irq_profile& p_first,
+                        const irq_profile& p_second) {
+    return p_first.priority < p_second.priority ||
+           (p_first.priority == p_second.priority &&
+            p_first.irq < p_second.irq);
+  };
+  auto preempts = [&](const irq_profile& p_other, const irq_profile& p_irq) {
+    return group(p_other) < group(p_irq) ||
+           (group(p_other) == group(p_irq) && taken_first(p_other, p_irq));
+  };
+
+  bool all_schedulable = true;
+  for (std::size_t i = 0; i < p_profiles.size(); i++) {
+    const auto& irq = p_profiles[i];
+    const std::uint64_t deadline =
+      irq.deadline != 0 ? irq.deadline : irq.min_interarrival;
+
+    std::uint64_t blocking = 0;
+    for (const auto& other : p_profiles) {
+      if (group(other) == group(irq) && taken_first(irq, other)) {
+        blocking = std::max<std::uint64_t>(blocking, other.wcet + p_overhead);
+      }
+    }
+
+    const std::uint64_t own = std::uint64_t{ irq.wcet } + p_overhead + blocking;
+    std::uint64_t response = own;
+    bool schedulable = true;
+    while (true) {
+      std::uint64_t next = own;
+      for (const auto& other : p_profiles) {
+        if (&other == &irq || !preempts(other, irq)) {
+          continue;
+        }
+        const std::uint64_t period = std::max<std::uint32_t>(
+          other.min_interarrival, 1);
+        next += ((response + period - 1) / period) *
+                (std::uint64_t{ other.wcet } + p_overhead);
+      }
+      if (next > deadline) {
+        response = next;
+        schedulable = false;
+        break;
+      }
+      if (next == response) {
+        break;
+      }
+      response = next;
+    }
+
+    p_responses[i] = irq_response{
+      .irq = irq.irq,
+      .response = response,
+      .slack = static_cast<std::int64_t>(deadline) -
+               static_cast<std::int64_t>(response),
+      .schedulable = schedulable,
+    };
+    all_schedulable = all_schedulable && schedulable;
+  }
+  return all_schedulable;
+}
+
+/// Number of 32-bit words each irq_profile takes in a dump
+inline constexpr std::size_t irq_profile_words = 4;
+
+/**
+ * @brief Serialize profiles into words for dumping to the host, for example
+ * through a debugger or a serial port.
+ *
+ * Each profile takes irq_profile_words words: the IRQ number and priority,
+ * the minimum interarrival time, the deadline and the WCET. decode_profiles()
+ * in schedulability_report.hpp reads them back.
+ *
+ * @param p_profiles - profiles to dump
+ * @param p_words - destination, at least p_profiles.size() *
+ * irq_profile_words long
+ * @return std::size_t - number of words written
+ */
+inline std::size_t dump_profiles(std::span<const irq_profile> p_profiles,
+                                 std::span<std::uint32_t> p_words)
+{
+  const auto count =
+    std::min(p_profiles.size(), p_words.size() / irq_profile_words);
+  for (std::size_t i = 0; i < count; i++) {
+    const auto& profile = p_profiles[i];
+    auto* words = &p_words[i * irq_profile_words];
+    words[0] = (static_cast<std::uint32_t>(profile.irq) << 8U) |
+               profile.priority;
+    words[1] = profile.min_interarrival;
+    words[2] = profile.deadline;
+    words[3] = profile.wcet;
+  }
+  return count * irq_profile_words;
+}
+}  // namespace embed::cortex_m
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "schedulability.hpp"
+
+namespace embed::cortex_m {
+/**
+ * @brief Decode profiles dumped with dump_profiles(). Allocates, so it is
+ * only meant for host tools and not for firmware.
+ *
+ * @param p_words - the dumped words
+ * @return std::vector<irq_profile> - the decoded profiles
+ */
+inline std::vector<irq_profile> decode_profiles(
+  std::span<const std::uint32_t> p_words)
+{
+  std::vector<irq_profile> profiles;
+  for (std::size_t i = 0; i + irq_profile_words <= p_words.size();
+       i += irq_profile_words) {
+    profiles.push_back(irq_profile{
+      .irq = static_cast<int>(p_words[i]) >> 8,
+      .priority = static_cast<std::uint8_t>(p_words[i] & 0xFFU),
+      .min_interarrival = p_words[i + 1],
+      .deadline = p_words[i + 2],
+      .wcet = p_words[i + 3],
+    });
+  }
+  return profiles;
+}
+
+/**
+ * @brief Format the results of response_time_analysis() as a table, one
+ * interrupt per line. Allocates, so it is only meant for host tools and not
+ * for firmware.
+ *
+ * @param p_responses - results of the analysis
+ * @return std::string - the report
+ */
+inline std::string to_report(std::span<const irq_response> p_responses)
+{
+  std::string report = "irq,response,slack,schedulable\n";
+  for (const auto& response : p_responses) {
+    std::array<char, 96> line{};
+    std::snprintf(line.data(),
+                  line.size(),
+                  "%d,%llu,%lld,%s\n",
+                  response.irq,
+                  static_cast<unsigned long long>(response.response),
+                  static_cast<long long>(response.slack),
+                  response.schedulable ? "yes" : "no");
+    report += line.data();
+  }
+  return report;
+}
+}  // namespace embed::cortex_m
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <type_traits>
+
+namespace embed::cortex_m {
+/**
+ * @brief Sequence lock for sharing the latest value of a small POD between a
+ * single writer and any number of readers without disabling interrupts.
+ *
+ * The writer never waits. A reader copies the value out and then checks that
+ * the sequence number did not change while it was copying. If it did, the
+ * writer preempted the reader part way through the copy and the copy is
+ * discarded.
+ *
+ * On a single core Cortex M, a reader that runs at a lower or equal priority
+ * to the writer (for example, a thread reading state published by an ISR) can
+ * only be interrupted by complete writes, so read() will succeed after at
+ * most a retry per write that lands during the copy. A reader that can preempt
+ * the writer (an ISR reading state published by a thread or lower priority
+ * ISR) can observe a write in progress that will not complete until the reader
+ * returns. Such readers must use try_read() and fall back to a previous value
+ * on failure, as spinning in read() would never terminate.
+ *
+ * Intended for small values, such as a few readings and a timestamp, where
+ * the copy is cheap. For large frames use triple_buffer.
+ *
+ * @tparam T - trivially copyable type to be shared
+ */
+template<typename T>
+class seqlock
+{
+public:
+  static_assert(std::is_trivially_copyable_v<T>,
+                "seqlock can only share trivially copyable types");
+
+  /// Number of 32-bit words used to hold a T
+  static constexpr std::size_t word_count =
+    (sizeof(T) + sizeof(std::uint32_t) - 1) / sizeof(std::uint32_t);
+
+  /**
+   * @brief Publish a new value. Must only ever be called by a single writer.
+   *
+   * @param p_value - new value to publish
+   */
+  void write(const T& p_value) noexcept
+  {
+    std::array<std::uint32_t, word_count> words{};
+    std::memcpy(words.data(), &p_value, sizeof(T));
+
+    const auto sequence = m_sequence.load(std::memory_order_relaxed);
+    // An odd sequence number marks a write in progress
+    m_sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (std::size_t i = 0; i < word_count; i++) {
+      m_data[i].store(words[i], std::memory_order_relaxed);
+    }
+
+    m_sequence.store(sequence + 2, std::memory_order_release);
+  }
+
+  /**
+   * @brief Attempt to read the latest value a single time.
+   *
+   * @return std::optional<T> - the latest value, or std::nullopt if a write
+   * was in progress or occurred during the read.
+   */
+  [[nodiscard]] std::optional<T> try_read() const noexcept
+  {
+    std::array<std::uint32_t, word_count> words{};
+
+    const auto before = m_sequence.load(std::memory_order_acquire);
+    if ((before & 1U) != 0U) {
+      return std::nullopt;
+    }
+
+    for (std::size_t i = 0; i < word_count; i++) {
+      words[i] = m_data[i].load(std::memory_order_relaxed);
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (m_sequence.load(std::memory_order_relaxed) != before) {
+      return std::nullopt;
+    }
+
+    T value;
+    std::memcpy(&value, words.data(), sizeof(T));
+    return value;
+  }
+
+  /**
+   * @brief Read the latest value, retrying until a consistent copy is made.
+   *
+   * Must only be called from a context that the writer can preempt. See the
+   * class description for details.
+   *
+   * @return T - the latest value
+   */
+  [[nodiscard]] T read() const noexcept
+  {
+    while (true) {
+      if (auto value = try_read()) {
+        return *value;
+      }
+    }
+  }
+
+  /**
+   * @return std::uint32_t - number of completed writes. Can be used by readers
+   * to detect that a new value has been published since their last read.
+   */
+  [[nodiscard]] std::uint32_t version() const noexcept
+  {
+    return m_sequence.load(std::memory_order_acquire) >> 1U;
+  }
+
+private:
+  std::atomic<std::uint32_t> m_sequence{};
+  std::array<std::atomic<std::uint32_t>, word_count> m_data{};
+};
+}  // namespace embed::cortex_m
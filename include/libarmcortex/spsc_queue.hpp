@@ -0,0 +1,153 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <type_traits>
+
+#include "system_control.hpp"
+
+namespace embed::cortex_m {
+/**
+ * @brief Wait-free single producer single consumer fixed capacity queue
+ *
+ * Intended for handing data between exactly one interrupt service routine and
+ * exactly one thread (or between two interrupts) without disabling interrupts.
+ * Each side only ever writes its own index, so neither side can be blocked by
+ * the other, regardless of which one preempts the other.
+ *
+ * The indices are free running 32-bit counters and are masked into the buffer
+ * which is why the capacity must be a power of two. The producer and consumer
+ * indices live on separate cache lines so that on cores with a data cache (M7)
+ * the two sides do not invalidate each other's lines on every operation.
+ *
+ * @tparam T - trivially copyable element type
+ * @tparam Capacity - number of elements, must be a power of two
+ */
+template<typename T, std::size_t Capacity>
+class spsc_queue
+{
+public:
+  static_assert(std::has_single_bit(Capacity),
+                "spsc_queue Capacity must be a power of two");
+  static_assert(Capacity <= (std::size_t{ 1 } << 31U),
+                "spsc_queue Capacity must fit within the 32-bit index space");
+  static_assert(std::is_trivially_copyable_v<T>,
+                "spsc_queue elements must be trivially copyable");
+
+  /// Mask used to convert a free running index into a buffer position
+  static constexpr auto mask = static_cast<std::uint32_t>(Capacity - 1);
+
+  /**
+   * @brief Push a single element into the queue. Must only be called by the
+   * producer.
+   *
+   * @param p_value - element to push
+   * @return true - element was pushed
+   * @return false - the queue is full and the element was dropped
+   */
+  [[nodiscard]] bool push(const T& p_value) noexcept
+  {
+    return push(std::span<const T>(&p_value, 1)) == 1;
+  }
+
+  /**
+   * @brief Push as many elements from the span as will fit. Must only be
+   * called by the producer.
+   *
+   * The elements become visible to the consumer all at once with a single
+   * index update, making this considerably cheaper than pushing the elements
+   * one by one.
+   *
+   * @param p_values - elements to push
+   * @return std::size_t - number of elements pushed
+   */
+  [[nodiscard]] std::size_t push(std::span<const T> p_values) noexcept
+  {
+    const auto tail = m_tail.load(std::memory_order_relaxed);
+    const auto head = m_head.load(std::memory_order_acquire);
+    const auto available = static_cast<std::uint32_t>(Capacity) - (tail - head);
+    const auto count = static_cast<std::uint32_t>(
+      std::min<std::size_t>(p_values.size(), available));
+
+    for (std::uint32_t i = 0; i < count; i++) {
+      m_buffer[(tail + i) & mask] = p_values[i];
+    }
+
+    m_tail.store(tail + count, std::memory_order_release);
+    return count;
+  }
+
+  /**
+   * @brief Pop a single element from the queue. Must only be called by the
+   * consumer.
+   *
+   * @return std::optional<T> - the oldest element or std::nullopt if the queue
+   * is empty.
+   */
+  [[nodiscard]] std::optional<T> pop() noexcept
+  {
+    T value{};
+    if (pop(std::span<T>(&value, 1)) == 0) {
+      return std::nullopt;
+    }
+    return value;
+  }
+
+  /**
+   * @brief Pop as many elements as are available into the span. Must only be
+   * called by the consumer.
+   *
+   * @param p_destination - location to copy the popped elements to
+   * @return std::size_t - number of elements popped
+   */
+  [[nodiscard]] std::size_t pop(std::span<T> p_destination) noexcept
+  {
+    const auto head = m_head.load(std::memory_order_relaxed);
+    const auto tail = m_tail.load(std::memory_order_acquire);
+    const auto count = static_cast<std::uint32_t>(
+      std::min<std::size_t>(p_destination.size(), tail - head));
+
+    for (std::uint32_t i = 0; i < count; i++) {
+      p_destination[i] = m_buffer[(head + i) & mask];
+    }
+
+    m_head.store(head + count, std::memory_order_release);
+    return count;
+  }
+
+  /**
+   * @return std::size_t - number of elements in the queue at the time of the
+   * call. May be stale by the time it is used if the other side is active.
+   */
+  [[nodiscard]] std::size_t size() const noexcept
+  {
+    // Load the consumer index first so that the producer index can only be
+    // further ahead of it, never behind.
+    const auto head = m_head.load(std::memory_order_acquire);
+    return m_tail.load(std::memory_order_acquire) - head;
+  }
+
+  /// @return true - if the queue held no elements at the time of the call
+  [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+  /// @return constexpr std::size_t - the capacity of the queue
+  [[nodiscard]] static constexpr std::size_t capacity() noexcept
+  {
+    return Capacity;
+  }
+
+private:
+  /// Consumer index, only written by the consumer
+  alignas(system_control::cache_line_size) std::atomic<std::uint32_t> m_head{};
+  /// Producer index, only written by the producer
+  alignas(system_control::cache_line_size) std::atomic<std::uint32_t> m_tail{};
+  /// Element storage, kept off of the lines holding the indices
+  alignas(system_control::cache_line_size) std::array<T, Capacity> m_buffer{};
+};
+}  // namespace embed::cortex_m
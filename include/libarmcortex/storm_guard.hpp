@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstdint>
+
+#include "atomic.hpp"
+#include "dwt_counter.hpp"
+#include "interrupt.hpp"
+
+namespace embed::cortex_m {
+/**
+ * @brief interrupt::trampoline hook that detects interrupt storms on an IRQ
+ * and throttles it by masking it for a backoff period.
+ *
+ * The enter hook counts the interrupts taken within fixed windows of
+ * WindowCycles CPU cycles. When more than MaxEvents are taken in one window,
+ * for example because a peripheral flag is stuck and never cleared, the IRQ
+ * is masked through the NVIC's ICER. poll() unmasks it once BackoffCycles
+ * have passed, so call it periodically from a context that keeps running
+ * while the IRQ is masked, such as a timer callback or the main loop. If the
+ * cause is still there, the requests that arrived while masked retrigger the
+ * storm and the guard trips again.
+ *
+ * The handler still runs for the interrupt that trips the guard. Within a
+ * window the handler runs at most MaxEvents + 1 times, which bounds the CPU
+ * time the IRQ can take. The check costs a cycle counter read, a subtract, an
+ * increment and three compares per interrupt.
+ *
+ *     using uart_guard = storm_guard<uart_irq, 1'000, 48'000'000, 480'000>;
+ *     interrupt(uart_irq).enable(
+ *       interrupt::trampoline<uart_handler, uart_guard>);
+ *
+ * The DWT cycle counter must have been started by constructing a dwt_counter.
+ *
+ * @tparam Irq - IRQ number being guarded
+ * @tparam MaxEvents - most interrupts allowed within a window
+ * @tparam WindowCycles - length of a window in CPU cycles
+ * @tparam BackoffCycles - CPU cycles to keep the IRQ masked after a storm
+ */
+template<int Irq,
+         std::uint32_t MaxEvents,
+         std::uint32_t WindowCycles,
+         std::uint32_t BackoffCycles>
+class storm_guard
+{
+public:
+  static_assert(Irq >= 0, "Core exceptions cannot be masked in the NVIC");
+  static_assert(MaxEvents > 0, "A window must allow at least one interrupt");
+  static_assert(WindowCycles > 0, "Window length must be greater than zero");
+
+  /// interrupt::trampoline hook, counts the interrupt and masks the IRQ if it
+  /// exceeds its rate
+  static void enter([[maybe_unused]] int p_irq) noexcept
+  {
+    const std::uint32_t now = dwt_counter::dwt()->cyccnt;
+    if (m_restart_window.load(std::memory_order_relaxed) ||
+        now - m_window_start >= WindowCycles) {
+      m_restart_window.store(false, std::memory_order_relaxed);
+      m_window_start = now;
+      m_events = 0;
+    }
+    m_events = m_events + 1;
+    if (m_events > m_peak.load(std::memory_order_relaxed)) {
+      m_peak.store(m_events, std::memory_order_relaxed);
+    }
+    if (m_events > MaxEvents) {
+      trip(now);
+    }
+  }
+
+  /// interrupt::trampoline hook, does nothing
+  static void exit([[maybe_unused]] int p_irq) noexcept {}
+
+  /**
+   * @brief Unmask the IRQ if it has been throttled for the backoff period.
+   *
+   * @return true - the IRQ is still throttled
+   * @return false - the IRQ is not throttled
+   */
+  static bool poll() noexcept
+  {
+    if (!m_throttled.load(std::memory_order_acquire)) {
+      return false;
+    }
+    if (dwt_counter::dwt()->cyccnt - m_tripped_at < BackoffCycles) {
+      return true;
+    }
+    m_throttled.store(false, std::memory_order_release);
+    (void)interrupt(Irq).unmask();
+    return false;
+  }
+
+  /// @return bool - the IRQ is masked because of a storm
+  static bool throttled() noexcept
+  {
+    return m_throttled.load(std::memory_order_acquire);
+  }
+
+  /// @return std::uint32_t - number of storms detected
+  static std::uint32_t storms() noexcept
+  {
+    return m_storms.load(std::memory_order_relaxed);
+  }
+
+  /// @return std::uint32_t - most interrupts taken within a window
+  static std::uint32_t peak() noexcept
+  {
+    return m_peak.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Clear the statistics and start a new window.
+   *
+   * The window is owned by the guarded interrupt, so it is only marked for a
+   * restart here and the next interrupt starts the new window.
+   */
+  static void reset() noexcept
+  {
+    m_restart_window.store(true, std::memory_order_relaxed);
+    m_storms.store(0, std::memory_order_relaxed);
+    m_peak.store(0, std::memory_order_relaxed);
+  }
+
+private:
+  static void trip(std::uint32_t p_now) noexcept
+  {
+    (void)interrupt(Irq).mask();
+    m_tripped_at = p_now;
+    m_window_start = p_now;
+    m_events = 0;
+    m_storms.fetch_add(1, std::memory_order_relaxed);
+    m_throttled.store(true, std::memory_order_release);
+  }
+
+  // Only written from the guarded interrupt, which cannot preempt itself.
+  // reset() requests a new window through m_restart_window instead.
+  static inline std::uint32_t m_window_start = 0;
+  static inline std::uint32_t m_events = 0;
+  static inline std::uint32_t m_tripped_at = 0;
+  static inline atomic<bool> m_restart_window{ false };
+  static inline atomic<bool> m_throttled{ false };
+  static inline atomic<std::uint32_t> m_storms{ 0 };
+  static inline atomic<std::uint32_t> m_peak{ 0 };
+};
+}  // namespace embed::cortex_m
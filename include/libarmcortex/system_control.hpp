@@ -1,11 +1,25 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 
 #include <libembeddedhal/config.hpp>
+#include <libxbitset/bitset.hpp>
+
+#include "barrier.hpp"
 
 namespace embed::cortex_m {
+/**
+ * @brief Determines if the target core has a floating point unit enabled by
+ * the compiler flags.
+ */
+#if defined(__ARM_FP)
+inline constexpr bool has_floating_point_unit = true;
+#else
+inline constexpr bool has_floating_point_unit = false;
+#endif
+
 /**
  * @brief Driver for controlling and inspect various aspects of the Cortex Mx
  * Systems such as interrupt vector table location, fault address locations and
@@ -57,14 +71,177 @@ public:
     /// Offset: 0x060 (R/ )  Instruction Set Attributes Register
     const std::array<volatile uint32_t, 5U> isar;
     /// Reserved 0
-    std::array<uint32_t, 5U> reserved0;
+    uint32_t reserved0;
+    /// Offset: 0x078 (R/ )  Cache Level ID Register
+    const volatile uint32_t clidr;
+    /// Offset: 0x07C (R/ )  Cache Type Register
+    const volatile uint32_t ctr;
+    /// Offset: 0x080 (R/ )  Cache Size ID Register
+    const volatile uint32_t ccsidr;
+    /// Offset: 0x084 (R/W)  Cache Size Selection Register
+    volatile uint32_t csselr;
     /// Offset: 0x088 (R/W)  Coprocessor Access Control Register
     volatile uint32_t cpacr;
   };
 
+  /// Structure type to access the floating point context registers
+  struct fpu_registers_t
+  {
+    /// Offset: 0x000 (R/W)  Floating-point Context Control Register
+    volatile uint32_t fpccr;
+    /// Offset: 0x004 (R/W)  Floating-point Context Address Register
+    volatile uint32_t fpcar;
+    /// Offset: 0x008 (R/W)  Floating-point Default Status Control Register
+    volatile uint32_t fpdscr;
+  };
+
+  /// Structure type to access the cache maintenance operations. Each register
+  /// performs its operation on the address or set/way written to it.
+  struct cache_registers_t
+  {
+    /// Offset: 0x000 ( /W)  Instruction cache invalidate all to PoU
+    volatile uint32_t iciallu;
+    /// Reserved 0
+    uint32_t reserved0;
+    /// Offset: 0x008 ( /W)  Instruction cache invalidate by address to PoU
+    volatile uint32_t icimvau;
+    /// Offset: 0x00C ( /W)  Data cache invalidate by address to PoC
+    volatile uint32_t dcimvac;
+    /// Offset: 0x010 ( /W)  Data cache invalidate by set/way
+    volatile uint32_t dcisw;
+    /// Offset: 0x014 ( /W)  Data cache clean by address to PoU
+    volatile uint32_t dccmvau;
+    /// Offset: 0x018 ( /W)  Data cache clean by address to PoC
+    volatile uint32_t dccmvac;
+    /// Offset: 0x01C ( /W)  Data cache clean by set/way
+    volatile uint32_t dccsw;
+    /// Offset: 0x020 ( /W)  Data cache clean and invalidate by address to PoC
+    volatile uint32_t dccimvac;
+    /// Offset: 0x024 ( /W)  Data cache clean and invalidate by set/way
+    volatile uint32_t dccisw;
+  };
+
+  /// Namespace containing the bitmask objects that are used to manipulate the
+  /// Configuration Control Register (CCR).
+  struct ccr_register
+  {
+    /// Fault on unaligned halfword and word accesses
+    static constexpr auto unaligned_trap = xstd::bitrange::from<3>();
+
+    /// Fault on integer division by zero rather than returning 0
+    static constexpr auto divide_by_zero_trap = xstd::bitrange::from<4>();
+
+    /// Align the stack to 8 bytes on exception entry
+    static constexpr auto stack_align = xstd::bitrange::from<9>();
+
+    /// Enable the data cache (Cortex M7)
+    static constexpr auto data_cache = xstd::bitrange::from<16>();
+
+    /// Enable the instruction cache (Cortex M7)
+    static constexpr auto instruction_cache = xstd::bitrange::from<17>();
+
+    /// Enable branch prediction (Cortex M7)
+    static constexpr auto branch_prediction = xstd::bitrange::from<18>();
+  };
+
+  /// Namespace containing the bitmask objects that are used to manipulate the
+  /// Application Interrupt and Reset Control Register (AIRCR).
+  struct aircr_register
+  {
+    /// PRIGROUP: priority bits above this bit number form the group priority,
+    /// which decides preemption, and the rest form the subpriority
+    static constexpr auto priority_group = xstd::bitrange::from<8, 10>();
+  };
+
+  /// Namespace containing the bitmask objects that are used to read the CPUID
+  /// Base Register.
+  struct cpuid_register
+  {
+    /// Part number of the processor, such as 0xC24 for the Cortex M4
+    static constexpr auto part_number = xstd::bitrange::from<4, 15>();
+  };
+
+  /// CPUID part number of the Cortex M3
+  static constexpr uint32_t cortex_m3_part_number = 0xC23;
+
+  /// CPUID part number of the Cortex M4
+  static constexpr uint32_t cortex_m4_part_number = 0xC24;
+
+  /// Namespace containing the bitmask objects that are used to manipulate the
+  /// Auxiliary Control Register (ACTLR) of the Cortex M3 and M4.
+  struct actlr_register
+  {
+    /// Disable interruption of multi-cycle instructions such as LDM and STM,
+    /// which increases interrupt latency
+    static constexpr auto disable_multicycle_interrupt =
+      xstd::bitrange::from<0>();
+
+    /// Disable write buffering, so bus faults on stores are precise
+    static constexpr auto disable_write_buffer = xstd::bitrange::from<1>();
+
+    /// Disable folding of IT instructions
+    static constexpr auto disable_it_folding = xstd::bitrange::from<2>();
+  };
+
+  /**
+   * @brief Core features that trade performance against robustness or
+   * debuggability, as set in CCR and ACTLR.
+   *
+   * Bits that the core does not implement read back as false, so compare the
+   * result of set_core_configuration() with the request to find out what the
+   * core supports. The ACTLR bits have other meanings on other cores, so they
+   * are only read and written on the Cortex M3 and M4, see
+   * has_m3_m4_auxiliary_control().
+   */
+  struct core_configuration
+  {
+    /// CCR.UNALIGN_TRP: fault on unaligned accesses
+    bool unaligned_trap = false;
+    /// CCR.DIV_0_TRP: fault on division by zero
+    bool divide_by_zero_trap = false;
+    /// CCR.STKALIGN: 8 byte stack alignment on exception entry
+    bool stack_align = true;
+    /// CCR.DC: data cache enabled (Cortex M7)
+    bool data_cache = false;
+    /// CCR.IC: instruction cache enabled (Cortex M7)
+    bool instruction_cache = false;
+    /// CCR.BP: branch prediction enabled (Cortex M7)
+    bool branch_prediction = false;
+    /// ACTLR.DISMCYCINT: multi-cycle instructions are not interruptible
+    bool disable_multicycle_interrupt = false;
+    /// ACTLR.DISDEFWBUF: write buffer disabled (Cortex M3/M4)
+    bool disable_write_buffer = false;
+    /// ACTLR.DISFOLD: IT folding disabled (Cortex M3/M4)
+    bool disable_it_folding = false;
+
+    /// @return bool - every field is equal
+    bool operator==(const core_configuration&) const = default;
+  };
+
   /// System control block address
   static constexpr intptr_t scb_address = 0xE000'ED00UL;
 
+  /// Auxiliary Control Register address
+  static constexpr intptr_t actlr_address = 0xE000'E008UL;
+
+  /// Cache maintenance operations address
+  static constexpr intptr_t cache_address = 0xE000'EF50UL;
+
+  /// Floating point context registers address
+  static constexpr intptr_t fpu_address = 0xE000'EF34UL;
+
+  /// FPCCR bit that saves the floating point context on exception entry when
+  /// it is in use
+  static constexpr uint32_t fpccr_automatic_save = 1U << 31U;
+
+  /// FPCCR bit that defers saving the floating point context until the
+  /// handler first uses the floating point unit (lazy stacking)
+  static constexpr uint32_t fpccr_lazy_save = 1U << 30U;
+
+  /// Size of a data cache line in bytes on the Cortex M7. Cores without a
+  /// cache are unaffected by alignment to this boundary beyond the padding.
+  static constexpr std::size_t cache_line_size = 32;
+
   /// @return auto* - Address of the Cortex M system control block register
   static auto* scb()
   {
@@ -74,6 +251,37 @@ public:
     }
     return reinterpret_cast<scb_registers_t*>(scb_address);
   }
+
+  /// @return auto* - Address of the Cortex M auxiliary control register
+  static auto* actlr()
+  {
+    if constexpr (embed::is_a_test()) {
+      static volatile uint32_t dummy_actlr{};
+      return &dummy_actlr;
+    }
+    return reinterpret_cast<volatile uint32_t*>(actlr_address);
+  }
+
+  /// @return auto* - Address of the Cortex M7 cache maintenance operations
+  static auto* cache()
+  {
+    if constexpr (embed::is_a_test()) {
+      static cache_registers_t dummy_cache{};
+      return &dummy_cache;
+    }
+    return reinterpret_cast<cache_registers_t*>(cache_address);
+  }
+
+  /// @return auto* - Address of the Cortex M floating point context registers
+  static auto* fpu()
+  {
+    if constexpr (embed::is_a_test()) {
+      static fpu_registers_t dummy_fpu{};
+      return &dummy_fpu;
+    }
+    return reinterpret_cast<fpu_registers_t*>(fpu_address);
+  }
+
   /**
    * @brief Enable the floating point unit coprocessor within Cortex M4 and
    * above processor.
@@ -85,6 +293,128 @@ public:
                                    (0b11 << 11 * 2)); /* set CP11 Full Access */
   }
 
+  /**
+   * @brief Determine if ACTLR has the Cortex M3 and M4 layout described by
+   * actlr_register, from the part number in CPUID.
+   *
+   * @return bool - the core is a Cortex M3 or M4
+   */
+  static bool has_m3_m4_auxiliary_control()
+  {
+    uint32_t cpuid = scb()->cpuid;
+    const auto part_number =
+      xstd::bitmanip(cpuid).extract<cpuid_register::part_number>();
+    return part_number == cortex_m3_part_number ||
+           part_number == cortex_m4_part_number;
+  }
+
+  /**
+   * @brief Determine which bits of an interrupt priority form its group
+   * priority, as selected by AIRCR.PRIGROUP. Only the group priority decides
+   * whether one interrupt preempts another, the subpriority only orders
+   * pending interrupts of the same group.
+   *
+   * @return std::uint8_t - mask of the group priority bits
+   */
+  static std::uint8_t priority_group_mask()
+  {
+    uint32_t aircr = scb()->aircr;
+    const auto priority_group =
+      xstd::bitmanip(aircr).extract<aircr_register::priority_group>();
+    return static_cast<std::uint8_t>(0xFFU << (priority_group + 1U));
+  }
+
+  /**
+   * @brief Apply a core configuration and read it back.
+   *
+   * The caches are invalidated before they are enabled, and the data cache is
+   * cleaned and invalidated before it is disabled, so memory stays coherent
+   * across the change. Changing the configuration while a DMA transfer is in
+   * flight is not safe.
+   *
+   * @param p_configuration - configuration to apply
+   * @return core_configuration - configuration read back from the core
+   */
+  core_configuration set_core_configuration(
+    const core_configuration& p_configuration)
+  {
+    const auto current = get_core_configuration();
+
+    if (has_m3_m4_auxiliary_control()) {
+      auto actlr_bits = xstd::bitmanip(*actlr());
+      assign(actlr_bits,
+             actlr_register::disable_multicycle_interrupt,
+             p_configuration.disable_multicycle_interrupt);
+      assign(actlr_bits,
+             actlr_register::disable_write_buffer,
+             p_configuration.disable_write_buffer);
+      assign(actlr_bits,
+             actlr_register::disable_it_folding,
+             p_configuration.disable_it_folding);
+    }
+
+    if (current.data_cache && !p_configuration.data_cache) {
+      xstd::bitmanip(scb()->ccr).reset(ccr_register::data_cache);
+      synchronize();
+      data_cache_by_set_way(cache()->dccisw);
+    } else if (!current.data_cache && p_configuration.data_cache) {
+      data_cache_by_set_way(cache()->dcisw);
+    }
+    if (!current.instruction_cache && p_configuration.instruction_cache) {
+      synchronize();
+      cache()->iciallu = 0;
+    }
+    synchronize();
+
+    {
+      auto ccr_bits = xstd::bitmanip(scb()->ccr);
+      assign(ccr_bits,
+             ccr_register::unaligned_trap,
+             p_configuration.unaligned_trap);
+      assign(ccr_bits,
+             ccr_register::divide_by_zero_trap,
+             p_configuration.divide_by_zero_trap);
+      assign(
+        ccr_bits, ccr_register::stack_align, p_configuration.stack_align);
+      assign(ccr_bits, ccr_register::data_cache, p_configuration.data_cache);
+      assign(ccr_bits,
+             ccr_register::instruction_cache,
+             p_configuration.instruction_cache);
+      assign(ccr_bits,
+             ccr_register::branch_prediction,
+             p_configuration.branch_prediction);
+    }
+    synchronize();
+
+    return get_core_configuration();
+  }
+
+  /**
+   * @brief Get the core configuration as currently set in CCR and ACTLR.
+   *
+   * @return core_configuration - the current configuration
+   */
+  core_configuration get_core_configuration()
+  {
+    uint32_t ccr = scb()->ccr;
+    uint32_t auxiliary = has_m3_m4_auxiliary_control() ? *actlr() : 0;
+    auto ccr_bits = xstd::bitmanip(ccr);
+    auto actlr_bits = xstd::bitmanip(auxiliary);
+    return core_configuration{
+      .unaligned_trap = ccr_bits.test(ccr_register::unaligned_trap),
+      .divide_by_zero_trap = ccr_bits.test(ccr_register::divide_by_zero_trap),
+      .stack_align = ccr_bits.test(ccr_register::stack_align),
+      .data_cache = ccr_bits.test(ccr_register::data_cache),
+      .instruction_cache = ccr_bits.test(ccr_register::instruction_cache),
+      .branch_prediction = ccr_bits.test(ccr_register::branch_prediction),
+      .disable_multicycle_interrupt =
+        actlr_bits.test(actlr_register::disable_multicycle_interrupt),
+      .disable_write_buffer =
+        actlr_bits.test(actlr_register::disable_write_buffer),
+      .disable_it_folding = actlr_bits.test(actlr_register::disable_it_folding),
+    };
+  }
+
   /**
    * @brief Set the address of the systems interrupt vector table
    *
@@ -132,5 +462,43 @@ public:
     // will be set to the address of the start of flash memory for the MCU.
     return reinterpret_cast<void*>(scb()->vtor);
   }
+
+private:
+  static void assign(auto& p_bits, xstd::bitrange p_range, bool p_value)
+  {
+    if (p_value) {
+      p_bits.set(p_range);
+    } else {
+      p_bits.reset(p_range);
+    }
+  }
+
+  static void synchronize()
+  {
+    data_synchronization_barrier();
+    instruction_synchronization_barrier();
+  }
+
+  /// Apply a set/way operation to every line of the level 1 data cache
+  static void data_cache_by_set_way(volatile uint32_t& p_operation)
+  {
+    // Select the level 1 data cache
+    scb()->csselr = 0;
+    synchronize();
+
+    const uint32_t size_id = scb()->ccsidr;
+    const uint32_t sets = ((size_id >> 13U) & 0x7FFFU) + 1U;
+    const uint32_t ways = ((size_id >> 3U) & 0x3FFU) + 1U;
+    // The way is held in the top bits, 30 and 31 for the 4 way Cortex M7
+    const uint32_t way_shift =
+      ways > 1 ? static_cast<uint32_t>(__builtin_clz(ways - 1U)) : 0U;
+
+    for (uint32_t set = 0; set < sets; set++) {
+      for (uint32_t way = 0; way < ways; way++) {
+        p_operation = (set << 5U) | (ways > 1 ? way << way_shift : 0U);
+      }
+    }
+    synchronize();
+  }
 };
 }  // namespace embed::cortex_m
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+
+#include <libembeddedhal/counter/interface.hpp>
+#include <libembeddedhal/frequency.hpp>
+#include <libxbitset/bitset.hpp>
+
+#include "atomic.hpp"
+#include "interrupt.hpp"
+#include "system_control.hpp"
+#include "systick_timer.hpp"
+
+namespace embed::cortex_m {
+/**
+ * @brief A 64-bit uptime counter built from the SysTick timer, for cores
+ * without a DWT cycle counter such as the Cortex M0 and M0+.
+ *
+ * SysTick runs free with the maximum 24-bit reload value. Each time it wraps,
+ * the SysTick interrupt increments a software epoch, and the uptime is the
+ * epoch combined with the ticks elapsed in the current period, so it has the
+ * full resolution of the SysTick clock.
+ *
+ * Reading the uptime does not disable interrupts. It samples the epoch, the
+ * SysTick pending bit, the current value and then the pending bit and epoch
+ * again, and retries if either changed. A wrap that happened before the sample
+ * but has not been serviced yet (because interrupts are masked or the reader
+ * is a higher priority interrupt) is seen through the pending bit and counted.
+ * Both can only change once per 2^24 ticks, so a read takes at most three
+ * passes. Interrupts must not be held off for a full period (2^24 ticks), or
+ * a wrap is lost.
+ *
+ * This driver takes exclusive ownership of SysTick and cannot be used along
+ * with systick_timer. The interrupt vector table must be initialized before
+ * constructing it.
+ */
+class systick_counter : public embed::counter
+{
+public:
+  /// Reload value of the free running counter, the largest SysTick supports
+  static constexpr std::uint32_t reload = 0x00FF'FFFFUL;
+  /// Number of ticks in each period of the counter
+  static constexpr std::uint64_t period = std::uint64_t{ reload } + 1;
+
+  /// Bit masks of the Interrupt Control and State Register
+  struct icsr_register
+  {
+    /// Set while the SysTick exception is pending, cleared on exception entry
+    static constexpr auto pend_systick_set = xstd::bitrange::from<26>();
+  };
+
+  /**
+   * @brief Construct a new systick counter object and start counting from 0
+   *
+   * @param p_frequency - the clock source's frequency
+   * @param p_source - the source of the clock to the systick timer
+   */
+  systick_counter(frequency p_frequency,
+                  systick_timer::clock_source p_source =
+                    systick_timer::clock_source::processor)
+    : m_frequency(p_frequency)
+  {
+    using control_register = systick_timer::control_register;
+    auto* sys_tick = systick_timer::sys_tick();
+
+    sys_tick->control = 0;
+    sys_tick->reload = reload;
+    sys_tick->current_value = 0;
+    m_epoch.store(0, std::memory_order_relaxed);
+
+    if (!cortex_m::interrupt(systick_timer::irq).enable(wrap)) {
+      std::abort();
+    }
+
+    auto control = xstd::bitmanip(sys_tick->control);
+    control.set(control_register::enable_interrupt);
+    if (p_source == systick_timer::clock_source::processor) {
+      control.set(control_register::clock_source);
+    }
+    control.set(control_register::enable_counter);
+  }
+
+  systick_counter(const systick_counter&) = delete;
+  systick_counter& operator=(const systick_counter&) = delete;
+
+  /**
+   * @brief Inform the driver of the operating frequency of the SysTick clock
+   * in order to generate the correct uptime.
+   *
+   * The count is not rescaled, so ticks counted before the change are
+   * reported at the new frequency.
+   *
+   * @param p_frequency - the clock source's frequency
+   */
+  void register_cpu_frequency(frequency p_frequency) noexcept
+  {
+    m_frequency = p_frequency;
+  }
+
+  ~systick_counter()
+  {
+    xstd::bitmanip(systick_timer::sys_tick()->control)
+      .reset(systick_timer::control_register::enable_counter);
+    if (!cortex_m::interrupt(systick_timer::irq).disable()) {
+      std::abort();
+    }
+  }
+
+private:
+  static void wrap()
+  {
+    // Only this interrupt writes the epoch, so a plain load and store is
+    // enough, even on cores without exclusive access instructions.
+    m_epoch.store(m_epoch.load(std::memory_order_relaxed) + 1,
+                  std::memory_order_release);
+  }
+
+  static bool wrap_pending()
+  {
+    std::uint32_t icsr = system_control::scb()->icsr;
+    return xstd::bitmanip(icsr).test(icsr_register::pend_systick_set);
+  }
+
+  boost::leaf::result<uptime_t> driver_uptime() noexcept override
+  {
+    std::uint32_t epoch = 0;
+    std::uint32_t value = 0;
+    bool pending = false;
+
+    while (true) {
+      epoch = m_epoch.load(std::memory_order_acquire);
+      pending = wrap_pending();
+      value = systick_timer::sys_tick()->current_value;
+      if (pending == wrap_pending() &&
+          epoch == m_epoch.load(std::memory_order_acquire)) {
+        break;
+      }
+    }
+
+    // SysTick pends on the 1 to 0 transition, a tick before it reloads, so a
+    // current value of 0 is the last tick of the period whose wrap has just
+    // been counted. Before the first clock edge after construction the
+    // current value is also 0, with no wrap counted, and is tick 0.
+    const std::uint64_t wraps = std::uint64_t{ epoch } + (pending ? 1 : 0);
+    std::uint64_t count = 0;
+    if (value != 0) {
+      count = wraps * period + (reload - value);
+    } else if (wraps != 0) {
+      count = wraps * period - 1;
+    }
+    return uptime_t{ .frequency = m_frequency, .count = count };
+  }
+
+  static inline atomic<std::uint32_t> m_epoch{ 0 };
+
+  frequency m_frequency;
+};
+}  // namespace embed::cortex_m
@@ -1,9 +1,16 @@
 #pragma once
 
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
 #include <functional>
 
+#include "atomic.hpp"
+#include "dwt_counter.hpp"
+#include "histogram.hpp"
 #include "interrupt.hpp"
+#include "seqlock.hpp"
+#include "trace.hpp"
 
 #include <libembeddedhal/config.hpp>
 #include <libembeddedhal/frequency.hpp>
@@ -73,6 +80,57 @@ public:
     processor = 1,
   };
 
+  /// Timing of a single run of the scheduled callback
+  struct callback_timing
+  {
+    /// Cycle count the timer was intended to expire at
+    std::uint32_t expiry;
+    /// Cycle count the interrupt service routine was entered at
+    std::uint32_t entry;
+    /// Cycles spent running the callback
+    std::uint32_t duration;
+  };
+
+  /**
+   * @brief Timing statistics of the scheduled callback, see instrument().
+   *
+   * When the DWT cycle counter is running and SysTick is clocked by the
+   * processor, every value is in CPU cycles measured with the cycle counter.
+   * Otherwise they are estimated in SysTick ticks from the current value
+   * register, which counts down from the reload value after each expiry, and
+   * `expiry` and `entry` of the last timing are relative to the expiry (so
+   * `expiry` is always 0). The fallback cannot see past a full period.
+   */
+  struct statistics
+  {
+    /// Number of buckets in each histogram
+    static constexpr std::size_t buckets = 16;
+
+    /**
+     * @brief Construct a new statistics object
+     *
+     * @param p_bucket_width - range of each histogram bucket in cycles
+     */
+    explicit statistics(std::uint32_t p_bucket_width)
+      : lateness(p_bucket_width)
+      , duration(p_bucket_width)
+    {}
+
+    /// Time from the intended expiry to entering the interrupt
+    histogram<buckets> lateness;
+    /// Time spent running the callback
+    histogram<buckets> duration;
+    /// Timing of the most recent run
+    seqlock<callback_timing> last{};
+    /// Expiries that passed without the callback running, plus runs that
+    /// did not finish before the following expiry
+    atomic<std::uint32_t> deadline_misses{ 0 };
+  };
+
+  /// Fewest ticks a preserved event is re-armed with after a frequency change,
+  /// enough for the counter to load it before the period is restored
+  static constexpr std::uint32_t rearm_minimum = 64;
+
   /// The address of the sys_tick register
   static constexpr intptr_t address = 0xE000'E010UL;
   /// The IRQ number for the SysTick interrupt vector
@@ -98,7 +156,10 @@ public:
                 clock_source p_source = clock_source::processor)
     : m_frequency(p_frequency)
   {
-    register_cpu_frequency(p_frequency, p_source);
+    // No event is scheduled yet, so there is nothing to re-arm that can fail
+    if (!register_cpu_frequency(p_frequency, p_source)) {
+      std::abort();
+    }
   }
 
   /**
@@ -110,16 +171,36 @@ public:
    * when expecting this function when there is the potentially other parts of
    * the system that depend on this counter's uptime to operate.
    *
-   * This will clear any ongoing scheduled events as the timing will no longer
-   * be valid.
+   * A scheduled event that is counting down is preserved. The time remaining
+   * until its next expiry is read from the current value register and
+   * rescaled to the new frequency, and the timer is re-armed to expire after
+   * that time and then every scheduled delay at the new frequency. The
+   * remaining time is rounded up to at least rearm_minimum ticks. Callbacks
+   * recording timing for instrument() measure against the new period and
+   * expiry from then on.
+   *
+   * If the scheduled delay no longer fits in the 24-bit counter at the new
+   * frequency, the event is not re-armed and the timer is left stopped.
    *
    * @param p_frequency - the clock source's frequency
    * @param p_source - the source of the clock to the systick timer
+   * @return boost::leaf::result<void> - out_of_bounds if the scheduled event
+   * could not be re-armed at the new frequency
    */
-  void register_cpu_frequency(frequency p_frequency,
-                              clock_source p_source = clock_source::processor)
+  boost::leaf::result<void> register_cpu_frequency(
+    frequency p_frequency,
+    clock_source p_source = clock_source::processor)
   {
+    const bool was_running = xstd::bitmanip(sys_tick()->control)
+                               .test(control_register::enable_counter);
     stop();
+
+    // Ticks left until the next expiry at the old frequency. A current value of
+    // 0 means the timer has just expired, so a whole period is left.
+    const std::uint32_t current_value = sys_tick()->current_value;
+    const std::uint64_t remaining =
+      current_value != 0 ? current_value : sys_tick()->reload;
+    const auto previous_frequency = m_frequency;
     m_frequency = p_frequency;
 
     // Since reloads only occur when the current_value falls from 1 to 0,
@@ -127,19 +208,48 @@ public:
     // reloading of the register and will stop the timer.
     sys_tick()->current_value = 0;
 
-    auto control = xstd::bitmanip(sys_tick()->control);
-    control.set(control_register::enable_interrupt);
+    {
+      auto control = xstd::bitmanip(sys_tick()->control);
+      control.set(control_register::enable_interrupt);
+
+      if (p_source == clock_source::processor) {
+        control.set(control_register::clock_source);
+      } else {
+        control.reset(control_register::clock_source);
+      }
+
+      // Disable the counter if it was previously enabled.
+      control.reset(control_register::enable_counter);
 
-    if (p_source == clock_source::processor) {
-      control.set(control_register::clock_source);
-    } else {
-      control.reset(control_register::clock_source);
+      // control will be committed to "sys_tick()->control" on destruction
     }
 
-    // Disable the counter if it was previously enabled.
-    control.reset(control_register::enable_counter);
+    if (was_running && m_period.count() > 0 &&
+        previous_frequency.cycles_per_second != 0) {
+      return rearm(remaining * p_frequency.cycles_per_second /
+                   previous_frequency.cycles_per_second);
+    }
+    return {};
+  }
 
-    // control will be committed to "sys_tick()->control" on destruction
+  /**
+   * @brief Record the timing of every run of callbacks scheduled after this
+   * call.
+   *
+   * Adds a few loads and stores of the cycle counter around each callback.
+   * Use it to tune interrupt priorities and catch latency regressions.
+   *
+   * Instrumented callbacks look up the statistics each time they run, so
+   * calling instrument(nullptr) stops recording immediately, including for
+   * callbacks already scheduled, and a different object passed later takes
+   * over their recording.
+   *
+   * @param p_statistics - where to record timing, must outlive the timer or a
+   * later call to instrument(nullptr), which disables instrumentation
+   */
+  void instrument(statistics* p_statistics)
+  {
+    m_statistics.store(p_statistics, std::memory_order_release);
   }
 
   /**
@@ -183,13 +293,58 @@ private:
   boost::leaf::result<void> driver_schedule(
     std::function<void(void)> p_callback,
     std::chrono::nanoseconds p_delay) noexcept override
+  {
+    const auto cycle_count = BOOST_LEAF_CHECK(reload_for(p_delay));
+
+    // Stop the previously scheduled event
+    stop();
+
+    if (m_statistics.load(std::memory_order_relaxed) != nullptr) {
+      p_callback = instrumented(std::move(p_callback), cycle_count);
+    }
+
+    if constexpr (trace::enabled) {
+      p_callback = [callback = std::move(p_callback)]() {
+        trace::record(trace_event_type::callback_begin, irq);
+        callback();
+        trace::record(trace_event_type::callback_end, irq);
+      };
+    }
+
+    // Save the p_callback to the static_callable object's statically allocated
+    // callback function. The lifetime of this object exists for the duration of
+    // the program, so there will never be a dangling reference.
+    auto handler = static_callable<systick_timer, 0, void(void)>(p_callback);
+
+    // Enable interrupt service routine for SysTick and use this callback as the
+    // handler
+    BOOST_LEAF_CHECK(cortex_m::interrupt(irq).enable(handler.get_handler()));
+
+    // Set the time reload value
+    sys_tick()->reload = cycle_count;
+    m_period = p_delay;
+
+    // Starting the timer will restart the count
+    start();
+
+    return {};
+  }
+
+  /**
+   * @param p_delay - time between expiries
+   * @return boost::leaf::result<std::uint32_t> - reload value that expires
+   * every p_delay at the current frequency, or out_of_bounds if it does not
+   * fit in the 24-bit counter
+   */
+  boost::leaf::result<std::uint32_t> reload_for(
+    std::chrono::nanoseconds p_delay)
   {
     static constexpr std::int64_t minimum = 0x00000001;
     static constexpr std::int64_t maximum = 0x00FFFFFF;
 
     auto cycle_count = BOOST_LEAF_CHECK(m_frequency.cycles_per(p_delay));
 
-    if (minimum < cycle_count && cycle_count <= maximum) {
+    if (cycle_count <= minimum || maximum < cycle_count) {
       auto min_duration =
         BOOST_LEAF_CHECK(m_frequency.duration_from_cycles(minimum));
       auto max_duration =
@@ -201,27 +356,117 @@ private:
       });
     }
 
-    // Stop the previously scheduled event
-    stop();
+    return static_cast<std::uint32_t>(cycle_count);
+  }
 
-    // Save the p_callback to the static_callable object's statically allocated
-    // callback function. The lifetime of this object exists for the duration of
-    // the program, so there will never be a dangling reference.
-    auto handler = static_callable<systick_timer, 0, void(void)>(p_callback);
+  /**
+   * @brief Restart the scheduled event so it expires after p_remaining ticks
+   * and then every m_period at the current frequency.
+   *
+   * @param p_remaining - ticks until the next expiry
+   * @return boost::leaf::result<void> - out_of_bounds if m_period does not fit
+   * in the counter at the current frequency, the timer is left stopped
+   */
+  boost::leaf::result<void> rearm(std::uint64_t p_remaining)
+  {
+    const auto reload = BOOST_LEAF_CHECK(reload_for(m_period));
+    // The remaining time is never more than a period, except for rounding
+    const auto remaining = std::min<std::uint64_t>(
+      std::max<std::uint64_t>(p_remaining, rearm_minimum), 0x00FF'FFFF);
+
+    // The counter loads the reload register when it is enabled, and then again
+    // each time it reaches zero. So load the remaining time first and switch
+    // the reload register to the period once the counter has picked it up.
+    sys_tick()->reload = static_cast<std::uint32_t>(remaining);
+    sys_tick()->current_value = 0;
+    // Instrumented callbacks measure against the new period and phase
+    m_instrumented_period.store(reload + 1, std::memory_order_relaxed);
+    m_instrumented_expiry.store(
+      dwt_counter::dwt()->cyccnt + static_cast<std::uint32_t>(remaining),
+      std::memory_order_relaxed);
+    start();
+    while (sys_tick()->current_value == 0) {
+      continue;
+    }
+    sys_tick()->reload = reload;
+    return {};
+  }
 
-    // Enable interrupt service routine for SysTick and use this callback as the
-    // handler
-    BOOST_LEAF_CHECK(cortex_m::interrupt(irq).enable(handler.get_handler()));
+  std::function<void(void)> instrumented(std::function<void(void)> p_callback,
+                                         std::uint32_t p_reload)
+  {
+    // SysTick counts from the reload value down to and including 0, so each
+    // period is one more cycle than the reload value.
+    m_instrumented_period.store(p_reload + 1, std::memory_order_relaxed);
+    m_instrumented_expiry.store(dwt_counter::dwt()->cyccnt + p_reload + 1,
+                                std::memory_order_relaxed);
+    const bool use_dwt =
+      (dwt_counter::dwt()->ctrl & dwt_counter::enable_cycle_count) != 0U &&
+      xstd::bitmanip(sys_tick()->control)
+        .test(control_register::clock_source);
+
+    if (!use_dwt) {
+      return [this, callback = std::move(p_callback)]() {
+        const std::uint32_t reload =
+          m_instrumented_period.load(std::memory_order_relaxed) - 1;
+        const std::uint32_t entry = reload - sys_tick()->current_value;
+        callback();
+        const std::uint32_t exit = reload - sys_tick()->current_value;
+        const std::uint32_t duration = exit >= entry ? exit - entry : 0;
+        if (auto* stats = m_statistics.load(std::memory_order_acquire)) {
+          record(*stats, { .expiry = 0, .entry = entry, .duration = duration });
+        }
+      };
+    }
 
-    // Set the time reload value
-    sys_tick()->reload = static_cast<uint32_t>(cycle_count);
+    return [this, callback = std::move(p_callback)]() {
+      const std::uint32_t entry = dwt_counter::dwt()->cyccnt;
+      const auto period = m_instrumented_period.load(std::memory_order_relaxed);
+      auto expiry = m_instrumented_expiry.load(std::memory_order_relaxed);
+      // SysTick only latches one expiry, any others that passed while the
+      // interrupt was held off are missed entirely. Entering slightly before
+      // the expected expiry is on time rather than ~2^32 cycles late.
+      const auto late = cycles_after(entry, expiry);
+      std::uint32_t lateness = late > 0 ? static_cast<std::uint32_t>(late) : 0;
+      std::uint32_t misses = lateness / period;
+      expiry += misses * period;
+      lateness -= misses * period;
+      callback();
+      const std::uint32_t duration = dwt_counter::dwt()->cyccnt - entry;
+      if (lateness + duration > period) {
+        misses++;
+      }
+      if (auto* stats = m_statistics.load(std::memory_order_acquire)) {
+        record(*stats,
+               { .expiry = expiry, .entry = entry, .duration = duration });
+        stats->deadline_misses.fetch_add(misses, std::memory_order_relaxed);
+      }
+      m_instrumented_expiry.store(expiry + period, std::memory_order_relaxed);
+    };
+  }
 
-    // Starting the timer will restart the count
-    start();
+  static void record(statistics& p_statistics, const callback_timing& p_timing)
+  {
+    const auto late = cycles_after(p_timing.entry, p_timing.expiry);
+    p_statistics.lateness.record(late > 0 ? static_cast<std::uint32_t>(late)
+                                          : 0);
+    p_statistics.duration.record(p_timing.duration);
+    p_statistics.last.write(p_timing);
+  }
 
-    return {};
+  /// Signed cycles from p_expiry to p_now, negative when p_now is before the
+  /// expiry, correct across cycle counter wrap around
+  static std::int32_t cycles_after(std::uint32_t p_now, std::uint32_t p_expiry)
+  {
+    return static_cast<std::int32_t>(p_now - p_expiry);
   }
 
   frequency m_frequency = frequency(1'000'000);
+  std::chrono::nanoseconds m_period{ 0 };
+  atomic<statistics*> m_statistics{ nullptr };
+  /// Cycles between expiries, followed by instrumented callbacks
+  atomic<std::uint32_t> m_instrumented_period{ 1 };
+  /// Cycle count of the next expiry, followed by instrumented callbacks
+  atomic<std::uint32_t> m_instrumented_expiry{ 0 };
 };
 }  // namespace embed::cortex_m
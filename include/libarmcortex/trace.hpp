@@ -0,0 +1,155 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "atomic.hpp"
+#include "config.hpp"
+#include "dwt_counter.hpp"
+
+namespace embed::cortex_m {
+/// Kinds of events recorded in a trace buffer
+enum class trace_event_type : std::uint16_t
+{
+  /// An interrupt service routine was entered, id is the IRQ number
+  irq_enter = 0,
+  /// An interrupt service routine returned, id is the IRQ number
+  irq_exit = 1,
+  /// A timer callback started, id is the IRQ of the timer
+  callback_begin = 2,
+  /// A timer callback returned, id is the IRQ of the timer
+  callback_end = 3,
+  /// A user marker, id is chosen by the application
+  marker = 4,
+};
+
+/// A single 8-byte trace record
+struct trace_event
+{
+  /// DWT cycle count when the event was recorded
+  std::uint32_t cycle_count;
+  /// What happened
+  trace_event_type type;
+  /// IRQ number or user marker id
+  std::int16_t id;
+};
+
+/**
+ * @brief Fixed-size circular buffer of interrupt and timer callback events,
+ * acting as a flight recorder that keeps the most recent events.
+ *
+ * Recording an event reserves a slot with a single atomic increment and then
+ * stores the DWT cycle count along with the event type and id, so it is safe
+ * to record from nested interrupts and costs a handful of cycles. Once the
+ * buffer wraps around, the oldest events are overwritten.
+ *
+ * The type provides the static enter() and exit() hooks expected by
+ * interrupt::trampoline, so an ISR can be traced with:
+ *
+ *     interrupt(irq).enable(interrupt::trampoline<handler, trace>);
+ *
+ * When Enabled is false every function compiles to nothing and no storage is
+ * allocated. The global `trace` alias is enabled through
+ * LIBARMCORTEX_ENABLE_TRACE, see config.hpp.
+ *
+ * @tparam Enabled - record events, otherwise every call is a no-op
+ * @tparam Capacity - number of events held, must be a power of two
+ */
+template<bool Enabled, std::size_t Capacity>
+class basic_trace
+{
+public:
+  static_assert(std::has_single_bit(Capacity),
+                "trace Capacity must be a power of two");
+
+  /// Whether events are recorded
+  static constexpr bool enabled = Enabled;
+
+  /**
+   * @brief Record an event
+   *
+   * @param p_type - kind of event
+   * @param p_id - IRQ number or user marker id
+   */
+  static void record(trace_event_type p_type, int p_id) noexcept
+  {
+    if constexpr (Enabled) {
+      const auto index = m_index.fetch_add(1, std::memory_order_relaxed);
+      auto& event = m_events[index & mask];
+      event.cycle_count = dwt_counter::dwt()->cyccnt;
+      event.type = p_type;
+      event.id = static_cast<std::int16_t>(p_id);
+    }
+  }
+
+  /**
+   * @brief Record a user marker
+   *
+   * @param p_id - application defined id of the marker
+   */
+  static void marker(int p_id) noexcept
+  {
+    record(trace_event_type::marker, p_id);
+  }
+
+  /// interrupt::trampoline hook, records an irq_enter event
+  static void enter(int p_irq) noexcept
+  {
+    record(trace_event_type::irq_enter, p_irq);
+  }
+
+  /// interrupt::trampoline hook, records an irq_exit event
+  static void exit(int p_irq) noexcept
+  {
+    record(trace_event_type::irq_exit, p_irq);
+  }
+
+  /**
+   * @brief Copy the recorded events, oldest first, for dumping to the host.
+   * There, to_chrome_trace_json() from trace_export.hpp can convert them for
+   * viewing.
+   *
+   * Events recorded while the copy is being made may or may not be included,
+   * so stop recording (or dump from a fault handler) for a consistent dump.
+   *
+   * @param p_destination - buffer of at least Capacity events
+   * @return std::size_t - number of events copied
+   */
+  static std::size_t snapshot(std::span<trace_event> p_destination) noexcept
+  {
+    if constexpr (!Enabled) {
+      return 0;
+    } else {
+      const auto end = m_index.load(std::memory_order_relaxed);
+      const auto count = std::min<std::size_t>(
+        { end, Capacity, p_destination.size() });
+      const auto start = end - static_cast<std::uint32_t>(count);
+      for (std::size_t i = 0; i < count; i++) {
+        p_destination[i] = m_events[(start + i) & mask];
+      }
+      return count;
+    }
+  }
+
+  /// Discard all recorded events
+  static void clear() noexcept
+  {
+    if constexpr (Enabled) {
+      m_index.store(0, std::memory_order_relaxed);
+    }
+  }
+
+private:
+  static constexpr auto mask = static_cast<std::uint32_t>(Capacity - 1);
+
+  static inline std::array<trace_event, Capacity> m_events{};
+  static inline atomic<std::uint32_t> m_index{ 0 };
+};
+
+/// Global trace buffer used by the drivers in this library
+using trace = basic_trace<config::trace, config::trace_capacity>;
+}  // namespace embed::cortex_m
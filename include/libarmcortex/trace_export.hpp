@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include <libembeddedhal/frequency.hpp>
+
+#include "trace.hpp"
+
+namespace embed::cortex_m {
+/**
+ * @brief Convert a trace dump into the Chrome trace event JSON format, which
+ * can be opened with Perfetto (ui.perfetto.dev) or chrome://tracing.
+ *
+ * Interrupts and timer callbacks become duration slices on separate tracks and
+ * user markers become instant events. The 32-bit cycle count is unwrapped
+ * assuming consecutive events are less than 2^32 cycles apart. Builds the
+ * document with the standard library, so it is only meant for host tools and
+ * not for firmware, which only needs trace.hpp.
+ *
+ * @param p_events - events as returned by basic_trace::snapshot()
+ * @param p_cpu_frequency - frequency of the DWT cycle counter
+ * @return std::string - JSON document
+ */
+inline std::string to_chrome_trace_json(std::span<const trace_event> p_events,
+                                        frequency p_cpu_frequency)
+{
+  const double cycles_per_microsecond =
+    static_cast<double>(p_cpu_frequency.cycles_per_second) / 1'000'000.0;
+
+  std::string json = "{\"traceEvents\":[";
+  std::uint64_t cycles = 0;
+  std::uint32_t previous = p_events.empty() ? 0 : p_events[0].cycle_count;
+
+  for (std::size_t i = 0; i < p_events.size(); i++) {
+    const auto& event = p_events[i];
+    cycles += event.cycle_count - previous;
+    previous = event.cycle_count;
+
+    std::string_view phase = "i";
+    std::string_view track = "markers";
+    std::string_view name = "marker ";
+    switch (event.type) {
+      case trace_event_type::irq_enter:
+      case trace_event_type::irq_exit:
+        track = "interrupts";
+        name = "IRQ ";
+        break;
+      case trace_event_type::callback_begin:
+      case trace_event_type::callback_end:
+        track = "callbacks";
+        name = "callback ";
+        break;
+      default:
+        break;
+    }
+    if (event.type == trace_event_type::irq_enter ||
+        event.type == trace_event_type::callback_begin) {
+      phase = "B";
+    } else if (event.type == trace_event_type::irq_exit ||
+               event.type == trace_event_type::callback_end) {
+      phase = "E";
+    }
+
+    std::array<char, 192> buffer{};
+    std::snprintf(buffer.data(),
+                  buffer.size(),
+                  "%s{\"name\":\"%.*s%d\",\"ph\":\"%.*s\",\"ts\":%.3f,"
+                  "\"pid\":0,\"tid\":\"%.*s\"%s}",
+                  i == 0 ? "" : ",",
+                  static_cast<int>(name.size()),
+                  name.data(),
+                  event.id,
+                  static_cast<int>(phase.size()),
+                  phase.data(),
+                  static_cast<double>(cycles) / cycles_per_microsecond,
+                  static_cast<int>(track.size()),
+                  track.data(),
+                  phase == "i" ? ",\"s\":\"t\"" : "");
+    json += buffer.data();
+  }
+
+  json += "]}";
+  return json;
+}
+}  // namespace embed::cortex_m
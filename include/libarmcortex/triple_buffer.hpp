@@ -0,0 +1,110 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "atomic.hpp"
+#include "system_control.hpp"
+
+namespace embed::cortex_m {
+/**
+ * @brief Triple buffer for handing large frames from a single writer to a
+ * single reader without copying and without disabling interrupts.
+ *
+ * Three buffers exist at all times. The writer owns the "back" buffer, the
+ * reader owns the "front" buffer and the third buffer sits in the middle.
+ * Ownership is handed over by atomically exchanging buffer indices with the
+ * middle slot, so the frame data itself is never copied and neither side ever
+ * waits on the other. This makes it safe to use regardless of which side
+ * preempts the other.
+ *
+ * The reader always gets the most recently published frame. Frames that are
+ * published faster than they are read are overwritten, which is the desired
+ * behavior for latest value sharing such as sensor frames or display buffers.
+ *
+ * Each buffer is aligned to the cache line size so that the writer filling its
+ * buffer does not share cache lines with the frame being read on cores with a
+ * data cache.
+ *
+ * @tparam T - frame type
+ */
+template<typename T>
+class triple_buffer
+{
+public:
+  /**
+   * @brief Get the buffer currently owned by the writer. Must only be called
+   * by the writer.
+   *
+   * The contents are whatever was last written to this buffer (which may be an
+   * older frame), not necessarily the last published frame.
+   *
+   * @return T& - buffer to fill before calling publish()
+   */
+  [[nodiscard]] T& write_buffer() noexcept
+  {
+    return m_buffers[m_back].frame;
+  }
+
+  /**
+   * @brief Hand the write buffer over to the reader and take ownership of a new
+   * write buffer. Must only be called by the writer.
+   *
+   */
+  void publish() noexcept
+  {
+    const auto previous =
+      m_middle.exchange(m_back | fresh, std::memory_order_acq_rel);
+    m_back = previous & index_mask;
+  }
+
+  /**
+   * @brief Take ownership of the most recently published frame if there is one.
+   * Must only be called by the reader.
+   *
+   * @return true - a new frame is available through read_buffer()
+   * @return false - no frame was published since the last update, the
+   * read_buffer() is unchanged.
+   */
+  [[nodiscard]] bool update() noexcept
+  {
+    if ((m_middle.load(std::memory_order_relaxed) & fresh) == 0U) {
+      return false;
+    }
+    const auto previous =
+      m_middle.exchange(m_front, std::memory_order_acq_rel);
+    m_front = previous & index_mask;
+    return true;
+  }
+
+  /**
+   * @brief Get the buffer currently owned by the reader. Must only be called by
+   * the reader.
+   *
+   * @return const T& - the frame acquired by the last successful update()
+   */
+  [[nodiscard]] const T& read_buffer() const noexcept
+  {
+    return m_buffers[m_front].frame;
+  }
+
+private:
+  /// Bit set in the middle index when it holds a frame the reader has not seen
+  static constexpr std::uint32_t fresh = 1U << 2U;
+  /// Mask to extract the buffer index from the middle index
+  static constexpr std::uint32_t index_mask = 0b11U;
+
+  struct alignas(system_control::cache_line_size) buffer_t
+  {
+    T frame{};
+  };
+
+  std::array<buffer_t, 3> m_buffers{};
+  /// Index of the buffer owned by the writer, only used by the writer
+  std::uint32_t m_back = 0;
+  /// Index of the buffer owned by the reader, only used by the reader
+  std::uint32_t m_front = 1;
+  /// Index of the buffer in the middle along with the fresh flag
+  atomic<std::uint32_t> m_middle{ 2 };
+};
+}  // namespace embed::cortex_m
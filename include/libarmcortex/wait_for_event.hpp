@@ -0,0 +1,137 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include <libembeddedhal/config.hpp>
+
+#include "dwt_counter.hpp"
+
+namespace embed::cortex_m {
+/**
+ * @brief Emulation of the Cortex M event register used when running as a test
+ * on a host machine.
+ *
+ * Every thread behaves as if it were its own core with its own event register.
+ * send_event() sets the register of every thread and wait_for_event() blocks
+ * (on a futex, via std::atomic::wait) until the calling thread's register is
+ * set and then clears it.
+ *
+ * @tparam Generation - counter type, only a template parameter so that nothing
+ * in here is instantiated when building for a Cortex M target.
+ */
+template<typename Generation = std::atomic<std::uint32_t>>
+class host_event_register
+{
+public:
+  /// Block until an event is sent, returning immediately if one was sent since
+  /// the last wait
+  static void wait() noexcept
+  {
+    auto generation = global().load(std::memory_order_acquire);
+    if (generation == seen()) {
+      global().wait(generation, std::memory_order_acquire);
+      generation = global().load(std::memory_order_acquire);
+    }
+    seen() = generation;
+  }
+
+  /// Set the event register of every thread and wake those that are waiting
+  static void send() noexcept
+  {
+    global().fetch_add(1, std::memory_order_release);
+    global().notify_all();
+  }
+
+private:
+  static Generation& global() noexcept
+  {
+    static Generation generation{};
+    return generation;
+  }
+
+  static std::uint32_t& seen() noexcept
+  {
+    static thread_local std::uint32_t generation = 0;
+    return generation;
+  }
+};
+
+/**
+ * @brief Put the core to sleep until an event occurs (WFE).
+ *
+ * Returns immediately, clearing it, if the event register is already set.
+ * The event register is set by send_event() (SEV), by exception entry and
+ * return, and may also be set spuriously, so callers must always re-check
+ * their wake-up condition.
+ *
+ * Because the event register latches, the sequence "check condition, then
+ * wait_for_event()" cannot lose a wake-up: an interrupt that satisfies the
+ * condition and calls send_event() between the check and the WFE leaves the
+ * register set and the WFE falls straight through.
+ */
+inline void wait_for_event() noexcept
+{
+  if constexpr (embed::is_a_test()) {
+    host_event_register<>::wait();
+  } else {
+    asm volatile("wfe" ::: "memory");
+  }
+}
+
+/**
+ * @brief Set the event register, waking any core sleeping in WFE (SEV).
+ *
+ * Safe to call from interrupt service routines.
+ */
+inline void send_event() noexcept
+{
+  if constexpr (embed::is_a_test()) {
+    host_event_register<>::send();
+  } else {
+    asm volatile("dsb\n\tsev" ::: "memory");
+  }
+}
+
+/**
+ * @brief Sleep in WFE until the condition holds.
+ *
+ * @param p_condition - callable returning true once the wait is satisfied
+ */
+template<typename Condition>
+void wait_for_event_until(Condition p_condition) noexcept
+{
+  while (!p_condition()) {
+    wait_for_event();
+  }
+}
+
+/**
+ * @brief Sleep in WFE until the condition holds or the timeout has elapsed.
+ *
+ * The timeout is measured with the DWT cycle counter, which must have been
+ * started by constructing a dwt_counter. WFE does not wake up when the
+ * deadline passes, so the deadline is only checked whenever the core wakes.
+ * To bound the overshoot, have a periodic interrupt running (for example the
+ * SysTick timer); its period is the worst case overshoot.
+ *
+ * @param p_condition - callable returning true once the wait is satisfied
+ * @param p_timeout_cycles - maximum number of CPU cycles to wait
+ * @return true - the condition was satisfied
+ * @return false - the timeout elapsed before the condition was satisfied
+ */
+template<typename Condition>
+[[nodiscard]] bool wait_for_event_until(Condition p_condition,
+                                        std::uint32_t p_timeout_cycles) noexcept
+{
+  const std::uint32_t start = dwt_counter::dwt()->cyccnt;
+  while (!p_condition()) {
+    const std::uint32_t elapsed = dwt_counter::dwt()->cyccnt - start;
+    if (elapsed >= p_timeout_cycles) {
+      return p_condition();
+    }
+    wait_for_event();
+  }
+  return true;
+}
+}  // namespace embed::cortex_m
@@ -0,0 +1,85 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include <boost/ut.hpp>
+#include <libarmcortex/arena_resource.hpp>
+
+namespace embed::cortex_m {
+boost::ut::suite arena_resource_test = []() {
+  using namespace boost::ut;
+
+  should("arena_resource::allocate() aligns & tracks usage") = []() {
+    // Setup
+    alignas(16) std::array<std::byte, 64> arena{};
+    arena_resource test_subject(arena);
+
+    // Exercise
+    auto* first = test_subject.allocate(3, 1);
+    auto* second = test_subject.allocate(8, 8);
+    const auto used = test_subject.used();
+    test_subject.deallocate(second, 8, 8);
+    const auto used_after_free = test_subject.used();
+    test_subject.deallocate(first, 3, 1);
+
+    // Verify
+    expect(first == arena.data());
+    expect(second == arena.data() + 8);
+    expect(that % 16 == used);
+    expect(that % 8 == used_after_free);
+    // Verify: the padding in front of the second allocation is kept
+    expect(that % 8 == test_subject.used());
+    expect(that % 16 == test_subject.high_water());
+    expect(that % 64 == test_subject.capacity());
+  };
+
+  should("arena_resource only reclaims the latest allocation") = []() {
+    // Setup
+    std::array<std::byte, 64> arena{};
+    arena_resource test_subject(arena);
+    auto* first = test_subject.allocate(16, 1);
+    auto* second = test_subject.allocate(16, 1);
+
+    // Exercise
+    test_subject.deallocate(first, 16, 1);
+    const auto used = test_subject.used();
+    test_subject.release();
+
+    // Verify
+    expect(second == arena.data() + 16);
+    expect(that % 32 == used);
+    expect(that % 0 == test_subject.used());
+    expect(that % 32 == test_subject.high_water());
+    expect(test_subject.allocate(1, 1) == arena.data());
+  };
+
+  should("arena_resource falls back upstream when exhausted") = []() {
+    // Setup
+    std::array<std::byte, 32> arena{};
+    arena_resource test_subject(arena, std::pmr::new_delete_resource());
+    arena_resource no_upstream(arena);
+    bool threw = false;
+
+    // Exercise
+    std::pmr::vector<std::uint32_t> values(&test_subject);
+    values.reserve(4);
+    const bool in_arena = values.data() == static_cast<void*>(arena.data());
+    values.reserve(16);
+    const bool upstream = values.data() != static_cast<void*>(arena.data());
+    try {
+      (void)no_upstream.allocate(33, 1);
+    } catch (const std::bad_alloc&) {
+      threw = true;
+    }
+
+    // Verify
+    expect(that % in_arena);
+    expect(that % upstream);
+    expect(that % 1 == test_subject.failures());
+    expect(that % threw);
+    expect(that % 1 == no_upstream.failures());
+  };
+};
+}  // namespace embed::cortex_m
@@ -0,0 +1,93 @@
+#include <array>
+#include <thread>
+#include <vector>
+
+#include <boost/ut.hpp>
+#include <libarmcortex/atomic.hpp>
+
+namespace embed::cortex_m {
+namespace {
+template<bool ExclusiveMonitor>
+void atomic_operations()
+{
+  using namespace boost::ut;
+
+  should("atomic::load() & atomic::store()") = []() {
+    atomic<std::uint32_t, ExclusiveMonitor> test_subject(5);
+    expect(that % 5 == test_subject.load());
+    test_subject.store(7);
+    expect(that % 7 == test_subject.load());
+  };
+
+  should("atomic::exchange()") = []() {
+    atomic<std::uint32_t, ExclusiveMonitor> test_subject(5);
+    expect(that % 5 == test_subject.exchange(9));
+    expect(that % 9 == test_subject.load());
+  };
+
+  should("atomic::compare_exchange_strong()") = []() {
+    atomic<std::uint32_t, ExclusiveMonitor> test_subject(5);
+    std::uint32_t expected = 4;
+    expect(that % !test_subject.compare_exchange_strong(expected, 8));
+    expect(that % 5 == expected);
+    expect(that % test_subject.compare_exchange_strong(expected, 8));
+    expect(that % 8 == test_subject.load());
+  };
+
+  should("atomic::fetch_add() & fetch_sub() & fetch_and() & fetch_or()") =
+    []() {
+      atomic<std::uint8_t, ExclusiveMonitor> test_subject(0xF0);
+      expect(that % 0xF0 == test_subject.fetch_add(0x0F));
+      expect(that % 0xFF == test_subject.fetch_sub(0x01));
+      expect(that % 0xFE == test_subject.fetch_and(0x3C));
+      expect(that % 0x3C == test_subject.fetch_or(0x01));
+      expect(that % 0x3D == test_subject.load());
+      // Verify: wraps around like an unsigned integer
+      expect(that % 0x3D == test_subject.fetch_add(0xC4));
+      expect(that % 0x01 == test_subject.load());
+    };
+
+  should("atomic<T*>::fetch_add()") = []() {
+    static std::array<std::uint32_t, 4> buffer{};
+    atomic<std::uint32_t*, ExclusiveMonitor> test_subject(buffer.data());
+    expect(buffer.data() == test_subject.fetch_add(3));
+    expect(&buffer[3] == test_subject.load());
+    expect(&buffer[3] == test_subject.fetch_sub(1));
+    expect(&buffer[2] == test_subject.load());
+  };
+
+  should("atomic contention: threads (ISRs) incrementing") = []() {
+    static constexpr std::uint32_t thread_count = 4;
+    static constexpr std::uint32_t increments = 20'000;
+    static constexpr std::uint32_t total = thread_count * increments;
+    static atomic<std::uint32_t, ExclusiveMonitor> counter(0);
+    static atomic<std::uint32_t, ExclusiveMonitor> cas_counter(0);
+
+    std::vector<std::thread> threads;
+    for (std::uint32_t i = 0; i < thread_count; i++) {
+      threads.emplace_back([]() {
+        for (std::uint32_t j = 0; j < increments; j++) {
+          counter.fetch_add(1, std::memory_order_relaxed);
+          auto value = cas_counter.load(std::memory_order_relaxed);
+          while (!cas_counter.compare_exchange_weak(value, value + 1)) {
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    expect(that % total == counter.load());
+    expect(that % total == cas_counter.load());
+  };
+}
+}  // namespace
+
+boost::ut::suite atomic_test = []() {
+  // Exercise & Verify: LDREX/STREX implementation (ARMv7-M and above)
+  atomic_operations<true>();
+  // Exercise & Verify: critical section implementation (ARMv6-M)
+  atomic_operations<false>();
+};
+}  // namespace embed::cortex_m
@@ -0,0 +1,108 @@
+#include <array>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <boost/ut.hpp>
+#include <libarmcortex/block_pool.hpp>
+
+namespace embed::cortex_m {
+boost::ut::suite block_pool_test = []() {
+  using namespace boost::ut;
+
+  should("block_pool::allocate() & block_pool::deallocate()") = []() {
+    // Setup
+    block_pool<10, 3, 8> test_subject;
+
+    // Exercise
+    auto* first = test_subject.allocate();
+    auto* second = test_subject.allocate();
+    auto* third = test_subject.allocate();
+    auto* exhausted = test_subject.allocate();
+    test_subject.deallocate(second);
+    const auto in_use_after_free = test_subject.in_use();
+    auto* reused = test_subject.allocate();
+    test_subject.deallocate(first);
+    test_subject.deallocate(nullptr);
+
+    // Verify
+    expect(that % 16 == test_subject.block_stride);
+    expect(first != nullptr);
+    expect(that % 16 == static_cast<std::byte*>(second) -
+                          static_cast<std::byte*>(first));
+    expect(that % 0 == reinterpret_cast<std::uintptr_t>(third) % 8);
+    expect(exhausted == nullptr);
+    expect(that % 2 == in_use_after_free);
+    expect(reused == second);
+    expect(that % 2 == test_subject.in_use());
+    expect(that % 3 == test_subject.high_water());
+    expect(that % 1 == test_subject.failures());
+    expect(that % test_subject.owns(third));
+    expect(that % !test_subject.owns(&test_subject + 1));
+  };
+
+  should("block_pool reuses freed blocks last in first out") = []() {
+    // Setup
+    block_pool<4, 4> test_subject;
+    std::array<void*, 4> blocks{};
+    for (auto& block : blocks) {
+      block = test_subject.allocate();
+    }
+
+    // Exercise
+    for (auto* block : blocks) {
+      test_subject.deallocate(block);
+    }
+    std::array<void*, 4> reused{};
+    for (auto& block : reused) {
+      block = test_subject.allocate();
+    }
+
+    // Verify
+    expect(reused[0] == blocks[3]);
+    expect(reused[1] == blocks[2]);
+    expect(reused[2] == blocks[1]);
+    expect(reused[3] == blocks[0]);
+    expect(test_subject.allocate() == nullptr);
+    expect(that % 4 == test_subject.high_water());
+  };
+
+  should("block_pool stress: threads (ISRs) allocate & free") = []() {
+    // Setup
+    static constexpr int thread_count = 4;
+    static constexpr int iterations = 20'000;
+    static block_pool<sizeof(std::uint32_t), 8> test_subject;
+    bool corrupted = false;
+
+    // Exercise
+    // Each thread stamps the blocks it holds with its id and checks that no
+    // other thread has written to them before freeing them.
+    std::vector<std::thread> threads;
+    for (int id = 0; id < thread_count; id++) {
+      threads.emplace_back([id, &corrupted]() {
+        for (int i = 0; i < iterations; i++) {
+          auto* block = static_cast<std::uint32_t*>(test_subject.allocate());
+          if (block == nullptr) {
+            std::this_thread::yield();
+            continue;
+          }
+          *block = static_cast<std::uint32_t>(id);
+          std::this_thread::yield();
+          if (*block != static_cast<std::uint32_t>(id)) {
+            corrupted = true;
+          }
+          test_subject.deallocate(block);
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    // Verify
+    expect(that % !corrupted);
+    expect(that % 0 == test_subject.in_use());
+    expect(that % thread_count >= test_subject.high_water());
+  };
+};
+}  // namespace embed::cortex_m
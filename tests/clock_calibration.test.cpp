@@ -0,0 +1,148 @@
+#include <atomic>
+#include <thread>
+
+#include <boost/ut.hpp>
+#include <libarmcortex/clock_calibration.hpp>
+
+namespace embed::cortex_m {
+namespace {
+constexpr std::uint32_t skew_bit = 1U << 30U;
+constexpr std::uint32_t noref_bit = 1U << 31U;
+
+/// CALIB is read only, so the dummy register is written through a cast
+void set_calib(std::uint32_t p_value)
+{
+  *const_cast<volatile std::uint32_t*>(&systick_timer::sys_tick()->calib) =
+    p_value;
+}
+
+/**
+ * @brief Simulate SysTick running from its reference clock while the CPU runs
+ * p_cycles_per_reload cycles per reload, for p_reloads reloads.
+ *
+ * Waits for the counter to be enabled with the p_tenms reload value, so a
+ * counter that was already running before the measurement reprograms it is
+ * ignored, and for each COUNTFLAG to be consumed before advancing the cycle
+ * counter and raising the next one.
+ */
+std::thread simulate_reloads(std::uint32_t p_reloads,
+                             std::uint32_t p_cycles_per_reload,
+                             std::uint32_t p_tenms = 9'999)
+{
+  return std::thread([p_reloads, p_cycles_per_reload, p_tenms]() {
+    constexpr std::uint32_t enable = 1U << 0U;
+    constexpr std::uint32_t count_flag = 1U << 16U;
+    auto* sys_tick = systick_timer::sys_tick();
+    for (std::uint32_t i = 0; i < p_reloads; i++) {
+      while (true) {
+        const std::uint32_t control = sys_tick->control;
+        if ((control & enable) != 0U && (control & count_flag) == 0U &&
+            sys_tick->reload == p_tenms) {
+          break;
+        }
+        std::this_thread::yield();
+      }
+      dwt_counter::dwt()->cyccnt =
+        dwt_counter::dwt()->cyccnt + p_cycles_per_reload;
+      std::atomic_thread_fence(std::memory_order_release);
+      sys_tick->control = sys_tick->control | count_flag;
+    }
+  });
+}
+}  // namespace
+
+boost::ut::suite clock_calibration_test = []() {
+  using namespace boost::ut;
+  using namespace std::chrono_literals;
+  using namespace embed::literals;
+
+  should("clock_calibration::reference_frequency()") = []() {
+    // Setup
+    // Exercise
+    auto one_megahertz = clock_calibration::reference_frequency(9'999);
+    auto skewed = clock_calibration::reference_frequency(skew_bit | 12'499);
+    auto no_reference = clock_calibration::reference_frequency(noref_bit);
+    auto unknown = clock_calibration::reference_frequency(0);
+
+    // Verify
+    expect(that % 1'000'000 == one_megahertz.value().cycles_per_second);
+    expect(that % 1'250'000 == skewed.value().cycles_per_second);
+    expect(!no_reference);
+    expect(!unknown);
+  };
+
+  should("clock_calibration::cross_count()") = []() {
+    // Setup
+    constexpr auto reference = 1_MHz;
+
+    // Exercise
+    // 100ms of a CPU configured for 48MHz but actually running 2% slow
+    constexpr auto slow =
+      clock_calibration::cross_count(4'704'000, 100'000, reference);
+    constexpr auto rounded = clock_calibration::cross_count(3, 2, 3_Hz);
+    constexpr auto empty = clock_calibration::cross_count(1, 0, reference);
+
+    // Verify
+    expect(that % 47'040'000 == slow.cycles_per_second);
+    expect(that % 5 == rounded.cycles_per_second);
+    expect(that % 0 == empty.cycles_per_second);
+  };
+
+  should("clock_calibration::measure() without a reference clock") = []() {
+    // Setup
+    set_calib(noref_bit | 9'999);
+
+    // Exercise
+    auto result = clock_calibration::measure();
+
+    // Verify
+    expect(!result);
+  };
+
+  should("clock_calibration::measure() skewed clock") = []() {
+    // Setup: 1MHz reference marked as skewed, CPU at 47.1MHz
+    constexpr std::uint32_t periods = 4;
+    constexpr std::uint32_t cycles_per_reload = 471'000;
+    auto* sys_tick = systick_timer::sys_tick();
+    set_calib(skew_bit | 9'999);
+    sys_tick->control = 0b111;
+    sys_tick->reload = 1234;
+    dwt_counter::dwt()->cyccnt = 0xFFF0'0000;
+    auto reloads = simulate_reloads(periods + 1, cycles_per_reload);
+
+    // Exercise
+    auto result = clock_calibration::measure(periods);
+    reloads.join();
+
+    // Verify
+    expect(that % 47'100'000 == result.value().cpu.cycles_per_second);
+    expect(that % 1'000'000 == result.value().reference.cycles_per_second);
+    expect(result.value().skewed);
+    expect(that % 0b111 == sys_tick->control);
+    expect(that % 1234 == sys_tick->reload);
+  };
+
+  should("clock_calibration::calibrate()") = []() {
+    // Setup: drivers configured for 48MHz, CPU actually at 47.1MHz
+    static constexpr size_t interrupt_count = 42;
+    interrupt::reinitialize<interrupt_count>();
+    set_calib(9'999);
+    dwt_counter dwt(48_MHz);
+    systick_timer systick(48_MHz);
+    auto reloads = simulate_reloads(11, 471'000);
+
+    // Exercise
+    auto result = clock_calibration::calibrate(systick, dwt);
+    reloads.join();
+    auto scheduled = systick.schedule([]() {}, 1ms);
+
+    // Verify
+    expect(that % 47'100'000 == result.value().cpu.cycles_per_second);
+    expect(!result.value().skewed);
+    expect(that % 47'100'000 ==
+           dwt.uptime().value().frequency.cycles_per_second);
+    expect(static_cast<bool>(scheduled));
+    expect(that % 47'100 == systick_timer::sys_tick()->reload);
+  };
+};
+}  // namespace embed::cortex_m
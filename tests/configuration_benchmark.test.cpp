@@ -0,0 +1,91 @@
+#include <array>
+#include <string_view>
+
+#include <boost/ut.hpp>
+#include <libarmcortex/configuration_benchmark.hpp>
+
+namespace embed::cortex_m {
+namespace {
+constexpr std::uint32_t cortex_m4_cpuid = 0x410F'C241;
+
+/// Takes 100 cycles, less with branch prediction and more without the write
+/// buffer
+void modeled_kernel()
+{
+  const auto configuration = system_control().get_core_configuration();
+  std::uint32_t cycles = 100;
+  if (configuration.branch_prediction) {
+    cycles -= 20;
+  }
+  if (configuration.disable_write_buffer) {
+    cycles += 50;
+  }
+  dwt_counter::dwt()->cyccnt = dwt_counter::dwt()->cyccnt + cycles;
+}
+}  // namespace
+
+boost::ut::suite configuration_benchmark_test = []() {
+  using namespace boost::ut;
+
+  should("benchmark_configuration()") = []() {
+    // Setup: a Cortex M4, CPUID is read only so it is written through a cast
+    *const_cast<volatile std::uint32_t*>(&system_control::scb()->cpuid) =
+      cortex_m4_cpuid;
+    system_control::scb()->ccr = 1U << 9U;
+    *system_control::actlr() = 0;
+    std::array<knob_result, core_knob_count> results{};
+
+    // Exercise
+    const auto count = benchmark_configuration(results, modeled_kernel, 4);
+
+    // Verify
+    expect(that % core_knob_count == count);
+    for (std::size_t i = 0; i < results.size(); i++) {
+      expect(that % i == static_cast<std::size_t>(results[i].knob));
+      expect(that % results[i].applied);
+      expect(that % 100 == results[i].baseline);
+    }
+    expect(that % 100 == results[0].cycles);
+    expect(that % 80 == results[2].cycles);
+    expect(that % 150 == results[3].cycles);
+    expect(that % (1U << 9U) == system_control::scb()->ccr);
+    expect(that % 0 == *system_control::actlr());
+  };
+
+  should("benchmark_configuration() with reference_kernel()") = []() {
+    // Setup
+    std::array<knob_result, 2> results{};
+
+    // Exercise
+    const auto count = benchmark_configuration(results);
+
+    // Verify: the host cycle counter does not advance
+    expect(that % 2 == count);
+    expect(that % 0 == results[1].cycles);
+  };
+
+  should("write_csv() for configuration results") = []() {
+    // Setup
+    const std::array<knob_result, 2> results{
+      knob_result{ .knob = core_knob::branch_prediction,
+                   .applied = true,
+                   .baseline = 100,
+                   .cycles = 80 },
+      knob_result{ .knob = core_knob::it_folding,
+                   .applied = false,
+                   .baseline = 100,
+                   .cycles = 100 },
+    };
+    std::array<char, 128> buffer{};
+
+    // Exercise
+    const auto length = write_csv(results, buffer);
+
+    // Verify
+    expect(std::string_view(buffer.data(), length) ==
+           "knob,applied,baseline,cycles\n"
+           "branch_prediction,yes,100,80\n"
+           "it_folding,no,100,100\n");
+  };
+};
+}  // namespace embed::cortex_m
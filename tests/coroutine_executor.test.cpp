@@ -0,0 +1,135 @@
+#include <boost/ut.hpp>
+#include <libarmcortex/coroutine_executor.hpp>
+
+#include "fake_timer.hpp"
+
+namespace embed::cortex_m {
+namespace {
+int steps = 0;
+
+coroutine_executor::task wait_on_irq(int p_irq)
+{
+  steps++;
+  bool fired = co_await coroutine_executor::irq_event(p_irq);
+  if (fired) {
+    steps++;
+  }
+}
+
+coroutine_executor::task sleeper(std::chrono::nanoseconds p_duration)
+{
+  steps++;
+  bool slept = co_await coroutine_executor::sleep_for(p_duration);
+  if (slept) {
+    steps++;
+  }
+}
+
+void fire_irq(int p_irq)
+{
+  // Simulate the hardware entering the exception for this IRQ
+  system_control::scb()->icsr =
+    static_cast<uint32_t>(p_irq + interrupt::core_interrupts);
+  interrupt::vector_table[static_cast<size_t>(
+    p_irq + interrupt::core_interrupts)]();
+  system_control::scb()->icsr = 0;
+}
+}  // namespace
+
+boost::ut::suite coroutine_executor_test = []() {
+  using namespace boost::ut;
+  using namespace std::chrono_literals;
+
+  static constexpr size_t interrupt_count = 42;
+  static constexpr size_t frame_count = 4;
+
+  coroutine_executor::initialize<frame_count>();
+  interrupt::initialize<interrupt_count>();
+
+  should("coroutine_executor::spawn() & irq_event") = [&] {
+    // Setup
+    static constexpr int expected_irq = 7;
+    steps = 0;
+
+    // Exercise
+    expect(that % coroutine_executor::spawn(wait_on_irq(expected_irq)));
+    expect(that % (frame_count - 1) == coroutine_executor::frames_available());
+    expect(that % coroutine_executor::run_once());
+
+    // Verify: suspended waiting on the interrupt
+    expect(that % 1 == steps);
+    expect(!coroutine_executor::run_once());
+    expect(coroutine_executor::irq_trampoline ==
+           interrupt::vector_table[interrupt::core_interrupts + expected_irq]);
+    expect((1U << expected_irq) & interrupt::nvic()->iser.at(0));
+
+    // Exercise: fire the interrupt
+    fire_irq(expected_irq);
+
+    // Verify: the IRQ is masked and the coroutine is ready but has not run
+    expect(that % 1 == steps);
+    expect((1U << expected_irq) & interrupt::nvic()->icer.at(0));
+    expect(interrupt::nop ==
+           interrupt::vector_table[interrupt::core_interrupts + expected_irq]);
+
+    // Verify: resuming completes the coroutine and releases its frame
+    expect(that % coroutine_executor::run_once());
+    expect(that % 2 == steps);
+    expect(that % frame_count == coroutine_executor::frames_available());
+  };
+
+  should("coroutine_executor::sleep_for") = [&] {
+    // Setup
+    fake_timer timer;
+    steps = 0;
+
+    // Exercise
+    expect(that % bool(coroutine_executor::start_ticks(timer, 1ms)));
+    expect(that % coroutine_executor::spawn(sleeper(3ms)));
+    expect(that % coroutine_executor::run_once());
+
+    // Verify
+    expect(that % 1ms == timer.delay);
+    expect(that % 1 == steps);
+    for (int i = 0; i < 3; i++) {
+      timer.callback();
+      expect(!coroutine_executor::run_once());
+    }
+    timer.callback();
+    expect(that % coroutine_executor::run_once());
+    expect(that % 2 == steps);
+    expect(that % frame_count == coroutine_executor::frames_available());
+  };
+
+  should("coroutine_executor arena exhaustion") = [&] {
+    // Setup
+    steps = 0;
+
+    // Exercise
+    for (size_t i = 0; i < frame_count; i++) {
+      expect(that % coroutine_executor::spawn(wait_on_irq(3)));
+    }
+    auto overflow = wait_on_irq(3);
+
+    // Verify: no frame is available and the empty task is rejected
+    expect(that % !bool(overflow));
+    expect(that % !coroutine_executor::spawn(std::move(overflow)));
+
+    // Exercise: all waiters are woken by one interrupt
+    while (coroutine_executor::run_once()) {
+    }
+    fire_irq(3);
+    while (coroutine_executor::run_once()) {
+    }
+
+    // Verify
+    expect(that % (frame_count * 2) == static_cast<size_t>(steps));
+    expect(that % frame_count == coroutine_executor::frames_available());
+  };
+
+  // Teardown: leave the vector table uninitialized for other test suites
+  interrupt::reinitialize<interrupt_count>();
+  interrupt::vector_table = {};
+  system_control().set_interrupt_vector_table_address(nullptr);
+};
+}  // namespace embed::cortex_m
@@ -0,0 +1,77 @@
+#include <atomic>
+#include <thread>
+
+#include <boost/ut.hpp>
+#include <libarmcortex/counting_semaphore.hpp>
+
+namespace embed::cortex_m {
+boost::ut::suite counting_semaphore_test = []() {
+  using namespace boost::ut;
+
+  should("counting_semaphore::release() & try_acquire()") = []() {
+    // Setup
+    counting_semaphore test_subject(1);
+
+    // Exercise & Verify
+    expect(that % 1 == test_subject.available());
+    expect(that % test_subject.try_acquire());
+    expect(that % !test_subject.try_acquire());
+    test_subject.release(2);
+    expect(that % 2 == test_subject.available());
+    expect(that % test_subject.try_acquire());
+    expect(that % test_subject.try_acquire());
+    expect(that % !test_subject.try_acquire());
+  };
+
+  should("counting_semaphore::acquire() released by thread (ISR)") = []() {
+    // Setup
+    static constexpr std::uint32_t total = 10'000;
+    static counting_semaphore test_subject;
+
+    // Exercise
+    std::thread isr([]() {
+      for (std::uint32_t i = 0; i < total; i++) {
+        test_subject.release();
+        if (i % 8 == 0) {
+          std::this_thread::yield();
+        }
+      }
+    });
+
+    for (std::uint32_t i = 0; i < total; i++) {
+      test_subject.acquire();
+    }
+    isr.join();
+
+    // Verify
+    expect(that % 0 == test_subject.available());
+  };
+
+  should("counting_semaphore::try_acquire_for() timeout") = []() {
+    // Setup
+    static counting_semaphore test_subject;
+    static std::atomic<bool> stop = false;
+
+    // Setup: stand in for a periodic interrupt that advances the cycle counter
+    // and wakes the core.
+    std::thread tick([]() {
+      while (!stop) {
+        dwt_counter::dwt()->cyccnt = dwt_counter::dwt()->cyccnt + 1'000;
+        send_event();
+        std::this_thread::yield();
+      }
+    });
+
+    // Exercise
+    auto timed_out = test_subject.try_acquire_for(5'000);
+    test_subject.release();
+    auto acquired = test_subject.try_acquire_for(5'000);
+    stop = true;
+    tick.join();
+
+    // Verify
+    expect(that % !timed_out);
+    expect(that % acquired);
+  };
+};
+}  // namespace embed::cortex_m
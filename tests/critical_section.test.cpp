@@ -0,0 +1,55 @@
+#include <atomic>
+#include <thread>
+
+#include <boost/ut.hpp>
+#include <libarmcortex/critical_section.hpp>
+
+namespace embed::cortex_m {
+boost::ut::suite critical_section_test = []() {
+  using namespace boost::ut;
+
+  should("critical_section nesting & exclusion") = []() {
+    // Setup
+    static std::atomic<bool> entered = false;
+    std::thread other;
+
+    {
+      // Exercise
+      critical_section outer;
+      {
+        critical_section inner;
+      }
+      // Verify: leaving the inner section must not unmask interrupts
+      other = std::thread([]() {
+        critical_section section;
+        entered = true;
+      });
+      std::this_thread::yield();
+      expect(that % !entered.load());
+    }
+
+    other.join();
+
+    // Verify
+    expect(that % entered.load());
+  };
+
+  should("critical_section::zero_latency_context") = []() {
+    // Setup
+    using context = critical_section::zero_latency_context;
+    const bool initially_active = context::active();
+
+    // Exercise
+    context::enter();
+    context::enter();
+    context::exit();
+    const bool nested_active = context::active();
+    context::exit();
+
+    // Verify
+    expect(that % !initially_active);
+    expect(that % nested_active);
+    expect(that % !context::active());
+  };
+};
+}  // namespace embed::cortex_m
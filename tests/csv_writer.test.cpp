@@ -0,0 +1,55 @@
+#include <array>
+#include <span>
+#include <string_view>
+
+#include <boost/ut.hpp>
+#include <libarmcortex/csv_writer.hpp>
+
+namespace embed::cortex_m {
+boost::ut::suite csv_writer_test = []() {
+  using namespace boost::ut;
+
+  should("csv_writer::append()") = []() {
+    // Setup
+    std::array<char, 32> buffer{};
+    buffer.fill('x');
+    csv_writer test_subject(buffer);
+
+    // Exercise
+    const auto empty = test_subject.size();
+    test_subject.append("name,cycles\n");
+    test_subject.append("%s,%d\n", "push", 12);
+
+    // Verify
+    expect(that % 0 == empty);
+    expect(std::string_view(buffer.data(), test_subject.size()) ==
+           "name,cycles\npush,12\n");
+    expect(that % '\0' == buffer[test_subject.size()]);
+  };
+
+  should("csv_writer::append() truncates") = []() {
+    // Setup
+    std::array<char, 8> buffer{};
+    csv_writer test_subject(buffer);
+
+    // Exercise
+    test_subject.append("0123456789\n");
+    test_subject.append("more\n");
+
+    // Verify
+    expect(that % (buffer.size() - 1) == test_subject.size());
+    expect(std::string_view(buffer.data()) == "0123456");
+  };
+
+  should("csv_writer with an empty buffer") = []() {
+    // Setup
+    csv_writer test_subject(std::span<char>{});
+
+    // Exercise
+    test_subject.append("text\n");
+
+    // Verify
+    expect(that % 0 == test_subject.size());
+  };
+};
+}  // namespace embed::cortex_m
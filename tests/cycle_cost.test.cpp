@@ -0,0 +1,85 @@
+#include <array>
+#include <string_view>
+
+#include <boost/ut.hpp>
+#include <libarmcortex/cycle_cost.hpp>
+
+namespace embed::cortex_m {
+boost::ut::suite cycle_cost_test = []() {
+  using namespace boost::ut;
+
+  should("fewest_cycles()") = []() {
+    // Setup: each run takes one cycle less than the one before, the warm up
+    // run takes the longest
+    std::uint32_t cost = 50;
+    std::size_t prepared = 0;
+    auto code = [&cost]() {
+      dwt_counter::dwt()->cyccnt = dwt_counter::dwt()->cyccnt + cost;
+      cost--;
+    };
+    auto prepare = [&prepared]() {
+      prepared++;
+      dwt_counter::dwt()->cyccnt = dwt_counter::dwt()->cyccnt + 1000;
+    };
+
+    // Exercise
+    const auto fewest = fewest_cycles(code, prepare, 4);
+
+    // Verify: the preparation is not measured
+    expect(that % 46 == fewest);
+    expect(that % 5 == prepared);
+  };
+
+  should("fewest_cycles() without preparation") = []() {
+    // Setup
+    std::size_t runs = 0;
+    auto code = [&runs]() {
+      runs++;
+      dwt_counter::dwt()->cyccnt = dwt_counter::dwt()->cyccnt + 20;
+    };
+
+    // Exercise
+    const auto fewest = fewest_cycles(code, 3);
+
+    // Verify
+    expect(that % 20 == fewest);
+    expect(that % 4 == runs);
+  };
+
+  should("cost_recorder::record()") = []() {
+    // Setup
+    std::array<operation_cost, 2> results{};
+    cost_recorder test_subject(results);
+
+    // Exercise
+    test_subject.record("push", 12);
+    test_subject.record({ .operation = "pop", .cycles = 14 });
+    test_subject.record("dropped", 16);
+
+    // Verify: results past the end of the span are dropped
+    expect(that % 2 == test_subject.size());
+    expect(std::string_view(results[0].operation) == "push");
+    expect(that % 12 == results[0].cycles);
+    expect(std::string_view(results[1].operation) == "pop");
+    expect(that % 14 == results[1].cycles);
+  };
+
+  should("write_csv() for operation costs") = []() {
+    // Setup
+    const std::array<operation_cost, 2> results{
+      operation_cost{ .operation = "spsc_queue::push", .cycles = 12 },
+      operation_cost{ .operation = "spsc_queue::pop", .cycles = 14 },
+    };
+    std::array<char, 64> buffer{};
+
+    // Exercise
+    const auto length = write_csv(results, buffer);
+
+    // Verify
+    expect(std::string_view(buffer.data(), length) ==
+           "operation,cycles\n"
+           "spsc_queue::push,12\n"
+           "spsc_queue::pop,14\n");
+  };
+};
+}  // namespace embed::cortex_m
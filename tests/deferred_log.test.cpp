@@ -0,0 +1,172 @@
+#include <array>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <boost/ut.hpp>
+#include <libarmcortex/deferred_log.hpp>
+#include <libarmcortex/deferred_log_decoder.hpp>
+
+extern "C" const char __start_libarmcortex_log[];
+extern "C" const char __stop_libarmcortex_log[];
+
+namespace embed::cortex_m {
+boost::ut::suite deferred_log_test = []() {
+  using namespace boost::ut;
+
+  auto make_decoder = []() {
+    return deferred_log_decoder(
+      std::span<const char>(__start_libarmcortex_log, __stop_libarmcortex_log),
+      static_cast<std::uint32_t>(
+        reinterpret_cast<std::uintptr_t>(__start_libarmcortex_log)));
+  };
+
+  should("deferred_log::write() encode record") = []() {
+    // Setup
+    deferred_log<64> test_subject;
+    dwt_counter::dwt()->cyccnt = 1234;
+    std::array<std::uint32_t, 64> words{};
+
+    // Exercise
+    LIBARMCORTEX_LOG(
+      test_subject, "a=%d b=%llu", -5, std::uint64_t{ 1 } << 40U);
+    const auto count = test_subject.read(words);
+
+    // Verify
+    expect(that % 6 == count);
+    expect(that % (0xA500'0000U | 3U) == words[0]);
+    expect(that % 1234 == words[2]);
+    expect(that % 0xFFFF'FFFBU == words[3]);
+    expect(that % 0 == words[4]);
+    expect(that % (1U << 8U) == words[5]);
+    expect(that % 0 == test_subject.dropped());
+  };
+
+  should("deferred_log_decoder::decode()") = [&]() {
+    // Setup
+    deferred_log<64> test_subject;
+    const auto decoder = make_decoder();
+    std::array<std::uint32_t, 64> words{};
+    std::vector<deferred_log_decoder::record> records;
+    dwt_counter::dwt()->cyccnt = 55;
+
+    // Exercise
+    LIBARMCORTEX_LOG(test_subject, "boot");
+    LIBARMCORTEX_LOG(test_subject,
+                     "%s: %5.2f%% x=0x%04X c=%c n=%lld",
+                     LIBARMCORTEX_LOG_STRING("adc"),
+                     12.5f,
+                     0xBEEFU,
+                     'z',
+                     -(std::int64_t{ 1 } << 33U));
+    const auto count = test_subject.read(words);
+    const auto consumed =
+      decoder.decode(std::span(words).first(count), records);
+
+    // Verify
+    expect(that % count == consumed);
+    expect(that % 2 == records.size());
+    expect(that % 55 == records[0].cycle_count);
+    expect(records[0].text == "boot");
+    expect(records[1].text == "adc: 12.50% x=0xBEEF c=z n=-8589934592");
+  };
+
+  should("deferred_log_decoder::decode() partial & corrupt records") = [&]() {
+    // Setup
+    deferred_log<64> test_subject;
+    const auto decoder = make_decoder();
+    std::array<std::uint32_t, 64> words{};
+    std::vector<deferred_log_decoder::record> records;
+
+    // Exercise
+    words[0] = 0xDEAD'BEEF;
+    LIBARMCORTEX_LOG(test_subject, "%u", 7U);
+    const auto count = test_subject.read(std::span(words).subspan(1));
+    const auto partial =
+      decoder.decode(std::span(words).first(count), records);
+    const auto complete =
+      decoder.decode(std::span(words).first(count + 1), records);
+
+    // Verify
+    expect(that % 4 == count);
+    expect(that % 1 == partial);
+    expect(that % (count + 1) == complete);
+    expect(that % 1 == records.size());
+    expect(records[0].text == "7");
+  };
+
+  should("deferred_log_decoder::decode() unknown format") = [&]() {
+    // Setup
+    const auto decoder = make_decoder();
+    std::vector<deferred_log_decoder::record> records;
+    const std::array<std::uint32_t, 3> words{ 0xA500'0000U, 0, 0 };
+
+    // Exercise
+    (void)decoder.decode(words, records);
+
+    // Verify
+    expect(that % 1 == records.size());
+    expect(records[0].text == "<unknown format string>");
+  };
+
+  should("deferred_log::write() drop when full") = []() {
+    // Setup
+    deferred_log<8> test_subject;
+
+    // Exercise
+    LIBARMCORTEX_LOG(test_subject, "%d %d", 1, 2);
+    LIBARMCORTEX_LOG(test_subject, "%d %d", 3, 4);
+
+    // Verify
+    expect(that % 1 == test_subject.dropped());
+  };
+
+  should("deferred_log::write() from concurrent writers") = [&]() {
+    // Setup
+    static constexpr int writers = 3;
+    static constexpr int per_writer = 200;
+    static constexpr int total = writers * per_writer;
+    deferred_log<4096> test_subject;
+    const auto decoder = make_decoder();
+    std::vector<std::uint32_t> stream;
+    std::vector<deferred_log_decoder::record> records;
+    std::vector<std::thread> threads;
+
+    // Exercise
+    for (int w = 0; w < writers; w++) {
+      threads.emplace_back([&test_subject, w]() {
+        for (int i = 0; i < per_writer; i++) {
+          LIBARMCORTEX_LOG(test_subject, "w%d i%d", w, i);
+        }
+      });
+    }
+    while (records.size() < total) {
+      std::array<std::uint32_t, 32> words{};
+      const auto count = test_subject.read(words);
+      stream.insert(stream.end(), words.begin(), words.begin() + count);
+      const auto consumed = decoder.decode(stream, records);
+      stream.erase(stream.begin(), stream.begin() + consumed);
+      if (count == 0) {
+        std::this_thread::yield();
+      }
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    // Verify
+    std::array<int, writers> next{};
+    bool in_order = true;
+    for (const auto& record : records) {
+      int w = 0;
+      int i = 0;
+      in_order = in_order &&
+                 std::sscanf(record.text.c_str(), "w%d i%d", &w, &i) == 2 &&
+                 next[w]++ == i;
+    }
+    expect(that % 0 == test_subject.dropped());
+    expect(that % total == records.size());
+    expect(that % in_order);
+  };
+};
+}  // namespace embed::cortex_m
@@ -0,0 +1,120 @@
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <boost/ut.hpp>
+#include <libarmcortex/dma_buffer.hpp>
+
+namespace embed::cortex_m {
+namespace {
+std::string maintenance;
+std::uintptr_t base = 0;
+
+struct recording_maintenance
+{
+  static constexpr bool enabled = true;
+
+  static void record(const char* p_operation, std::uintptr_t p_address)
+  {
+    maintenance += p_operation;
+    maintenance += std::to_string(p_address - base);
+    maintenance += ' ';
+  }
+  static void clean(std::uintptr_t p_address) { record("c", p_address); }
+  static void invalidate(std::uintptr_t p_address) { record("i", p_address); }
+  static void clean_invalidate(std::uintptr_t p_address)
+  {
+    record("ci", p_address);
+  }
+  static void synchronize() { maintenance += "| "; }
+};
+}  // namespace
+
+boost::ut::suite dma_buffer_test = []() {
+  using namespace boost::ut;
+
+  should("dma_buffer is aligned and padded to cache lines") = []() {
+    // Setup
+    struct neighbors
+    {
+      char before;
+      dma_buffer<std::uint8_t, 40> buffer;
+      char after;
+    };
+
+    // Exercise
+    neighbors test_subject{};
+
+    // Verify
+    expect(that % 64 == sizeof(dma_buffer<std::uint8_t, 40>));
+    expect(that % 32 == sizeof(dma_buffer<std::uint32_t, 8>));
+    expect(that % 0 == reinterpret_cast<std::uintptr_t>(
+                         test_subject.buffer.data().data()) %
+                         system_control::cache_line_size);
+    expect(that % 40 == test_subject.buffer.size());
+    expect(that % 64 == reinterpret_cast<char*>(&test_subject.after) -
+                          reinterpret_cast<char*>(&test_subject.buffer));
+  };
+
+  should("dma_buffer::to_device() & dma_buffer::to_cpu()") = []() {
+    // Setup
+    dma_buffer<std::uint16_t, 40, recording_maintenance> test_subject;
+    base = reinterpret_cast<std::uintptr_t>(test_subject.data().data());
+
+    // Exercise & Verify: 40 halfwords span 3 cache lines
+    maintenance.clear();
+    test_subject.to_device(dma_access::read);
+    expect(maintenance == "| c0 c32 c64 | ");
+
+    maintenance.clear();
+    test_subject.to_cpu(dma_access::read);
+    expect(maintenance == "");
+
+    maintenance.clear();
+    test_subject.to_device(dma_access::write);
+    test_subject.to_cpu(dma_access::write, 17);
+    expect(maintenance == "| i0 i32 i64 | | i0 i32 | ");
+
+    maintenance.clear();
+    test_subject.to_device(dma_access::read_write, 16);
+    test_subject.to_cpu(dma_access::read_write, 100);
+    expect(maintenance == "| ci0 | | i0 i32 i64 | ");
+  };
+
+  should("dma_buffer with scb_cache_maintenance") = []() {
+    // Setup
+    dma_buffer<std::uint8_t, 64, scb_cache_maintenance> test_subject;
+    // The registers are 32 bits wide, like the target's addresses
+    const auto address = static_cast<std::uint32_t>(
+      reinterpret_cast<std::uintptr_t>(test_subject.data().data()));
+    system_control::cache()->dccmvac = 0;
+    system_control::cache()->dcimvac = 0;
+
+    // Exercise
+    test_subject.to_device(dma_access::read);
+    const auto cleaned = system_control::cache()->dccmvac;
+    test_subject.to_cpu(dma_access::write, 1);
+
+    // Verify: the registers hold the last line written to them
+    expect(that % 0x020 ==
+           offsetof(system_control::cache_registers_t, dccimvac));
+    expect(that % (address + 32) == cleaned);
+    expect(that % address == system_control::cache()->dcimvac);
+  };
+
+  should("dma_buffer with no_cache_maintenance") = []() {
+    // Setup
+    dma_buffer<std::uint8_t, 8, no_cache_maintenance> test_subject;
+    system_control::cache()->dccmvac = 0;
+
+    // Exercise
+    test_subject.data()[0] = 42;
+    test_subject.to_device(dma_access::read);
+    test_subject.to_cpu(dma_access::write);
+
+    // Verify
+    expect(that % 0 == system_control::cache()->dccmvac);
+    expect(that % 42 == test_subject.data()[0]);
+  };
+};
+}  // namespace embed::cortex_m
@@ -0,0 +1,79 @@
+#include <boost/ut.hpp>
+#include <libarmcortex/entry_latency.hpp>
+
+namespace embed::cortex_m {
+namespace {
+constexpr int probe_irq = 11;
+using probe = entry_latency<probe_irq>;
+
+void slow_handler()
+{
+  dwt_counter::dwt()->cyccnt = dwt_counter::dwt()->cyccnt + 30;
+  probe::mark();
+}
+}  // namespace
+
+boost::ut::suite entry_latency_test = []() {
+  using namespace boost::ut;
+
+  static constexpr size_t interrupt_count = 42;
+  interrupt::reinitialize<interrupt_count>();
+
+  should("entry_latency::measure()") = []() {
+    // Setup
+    dwt_counter::dwt()->cyccnt = 1'000;
+    interrupt::nvic()->stir = 0;
+    interrupt::nvic()->icer.at(0) = 0;
+
+    // Exercise
+    auto latency = probe::measure(slow_handler, 4);
+
+    // Verify
+    expect(that % static_cast<bool>(latency));
+    expect(that % 30 == latency.value());
+    expect(that % 1'120 == dwt_counter::dwt()->cyccnt);
+    expect(that % probe_irq == interrupt::nvic()->stir);
+    expect(that % (1U << probe_irq) == interrupt::nvic()->icer.at(0));
+  };
+
+  should("entry_latency::sample()") = []() {
+    // Setup
+    const bool enabled =
+      static_cast<bool>(interrupt(probe_irq).enable(slow_handler));
+
+    // Exercise: work before start() is not part of the span
+    const auto cycles = probe::sample([]() {
+      dwt_counter::dwt()->cyccnt = dwt_counter::dwt()->cyccnt + 50;
+      probe::start();
+      probe::request();
+    });
+
+    // Verify
+    expect(that % enabled);
+    expect(that % 30 == cycles);
+    expect(that % static_cast<bool>(interrupt(probe_irq).disable()));
+  };
+
+  should("entry_latency::measure_dispatch_styles()") = []() {
+    // Setup
+    interrupt::nvic()->stir = 0;
+
+    // Exercise
+    auto latency = probe::measure_dispatch_styles(2);
+
+    // Verify: every style reached mark(); the host has no cycles to count
+    expect(that % static_cast<bool>(latency));
+    expect(that % 0 == latency.value().raw);
+    expect(that % 0 == latency.value().trampoline);
+    expect(that % 0 == latency.value().static_callable);
+    expect(that % 0 == latency.value().function);
+    expect(that % 0 == latency.value().chain);
+    expect(that % probe_irq == interrupt::nvic()->stir);
+  };
+
+  // Teardown: leave the vector table uninitialized for other test suites
+  interrupt::reinitialize<interrupt_count>();
+  interrupt::vector_table = {};
+  system_control().set_interrupt_vector_table_address(nullptr);
+};
+}  // namespace embed::cortex_m
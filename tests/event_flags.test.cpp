@@ -0,0 +1,84 @@
+#include <atomic>
+#include <thread>
+
+#include <boost/ut.hpp>
+#include <libarmcortex/event_flags.hpp>
+
+namespace embed::cortex_m {
+boost::ut::suite event_flags_test = []() {
+  using namespace boost::ut;
+
+  should("event_flags::set() & try_wait_any() & try_wait_all()") = []() {
+    // Setup
+    event_flags test_subject;
+
+    // Exercise & Verify
+    expect(that % 0 == test_subject.try_wait_any(0b1111));
+    test_subject.set(0b0101);
+    expect(that % 0b0101 == test_subject.get());
+    expect(that % !test_subject.try_wait_all(0b0111));
+    expect(that % 0b0101 == test_subject.get());
+    expect(that % 0b0100 == test_subject.try_wait_any(0b0110));
+    expect(that % 0b0001 == test_subject.get());
+    test_subject.set(0b0110);
+    expect(that % test_subject.try_wait_all(0b0111));
+    expect(that % 0 == test_subject.get());
+    test_subject.set(0b1000);
+    test_subject.clear(0b1000);
+    expect(that % 0 == test_subject.get());
+  };
+
+  should("event_flags::wait_any() & wait_all() woken by thread (ISR)") = []() {
+    // Setup
+    static event_flags test_subject;
+
+    // Exercise
+    std::thread isr([]() {
+      std::this_thread::yield();
+      test_subject.set(0b0010);
+      std::this_thread::yield();
+      test_subject.set(0b0100);
+      std::this_thread::yield();
+      test_subject.set(0b1000);
+    });
+
+    auto first = test_subject.wait_any(0b0010);
+    test_subject.wait_all(0b1100);
+    isr.join();
+
+    // Verify
+    expect(that % 0b0010 == first);
+    expect(that % 0 == test_subject.get());
+  };
+
+  should("event_flags::wait_any_for() & wait_all_for() timeout") = []() {
+    // Setup
+    static event_flags test_subject;
+    static std::atomic<bool> stop = false;
+    dwt_counter::dwt()->cyccnt = 0xFFFF'F000;
+
+    // Setup: stand in for a periodic interrupt that advances the cycle counter
+    // and wakes the core.
+    std::thread tick([]() {
+      while (!stop) {
+        dwt_counter::dwt()->cyccnt = dwt_counter::dwt()->cyccnt + 1'000;
+        send_event();
+        std::this_thread::yield();
+      }
+    });
+
+    // Exercise
+    test_subject.set(0b0001);
+    auto any = test_subject.wait_any_for(0b0110, 10'000);
+    auto all = test_subject.wait_all_for(0b0011, 10'000);
+    auto present = test_subject.wait_any_for(0b0001, 10'000);
+    stop = true;
+    tick.join();
+
+    // Verify
+    expect(that % 0 == any);
+    expect(that % !all);
+    expect(that % 0b0001 == present);
+  };
+};
+}  // namespace embed::cortex_m
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+
+#include <libembeddedhal/error.hpp>
+#include <libembeddedhal/timer/interface.hpp>
+
+namespace embed::cortex_m {
+/// Timer that records the scheduled callback rather than running it
+class fake_timer : public embed::timer
+{
+public:
+  std::function<void(void)> callback{};
+  std::chrono::nanoseconds delay{};
+
+private:
+  boost::leaf::result<bool> driver_is_running() noexcept override
+  {
+    return bool(callback);
+  }
+  boost::leaf::result<void> driver_clear() noexcept override
+  {
+    callback = nullptr;
+    return {};
+  }
+  boost::leaf::result<void> driver_schedule(
+    std::function<void(void)> p_callback,
+    std::chrono::nanoseconds p_delay) noexcept override
+  {
+    callback = p_callback;
+    delay = p_delay;
+    return {};
+  }
+};
+}  // namespace embed::cortex_m
@@ -0,0 +1,146 @@
+#include <boost/ut.hpp>
+#include <libarmcortex/fixed_rate_runner.hpp>
+
+#include "fake_timer.hpp"
+
+namespace embed::cortex_m {
+namespace {
+/// Simulate the callback taking the given number of cycles
+void advance(std::uint32_t p_cycles)
+{
+  dwt_counter::dwt()->cyccnt = dwt_counter::dwt()->cyccnt + p_cycles;
+}
+
+/// Fire the fake timer's interrupt at the given cycle count
+void fire_at(fake_timer& p_timer, std::uint32_t p_cycle)
+{
+  dwt_counter::dwt()->cyccnt = p_cycle;
+  p_timer.callback();
+}
+}  // namespace
+
+boost::ut::suite fixed_rate_runner_test = []() {
+  using namespace boost::ut;
+  using namespace std::chrono_literals;
+  using namespace embed::literals;
+
+  should("fixed_rate_runner::start() & jitter") = []() {
+    // Setup
+    fake_timer timer;
+    fixed_rate_runner test_subject(timer, 1_MHz);
+    auto callback = []() { advance(10); };
+
+    // Exercise
+    const bool started =
+      static_cast<bool>(test_subject.start(callback, 100us));
+    fire_at(timer, 1'000);
+    fire_at(timer, 1'103);
+    fire_at(timer, 1'205);
+
+    // Verify
+    expect(that % started);
+    expect(100us == timer.delay);
+    expect(that % 3 == test_subject.runs());
+    expect(that % 5 == test_subject.worst_latency());
+    expect(that % 3 == test_subject.jitter().count(0));
+    expect(that % 0 == test_subject.overrun_count());
+    expect(that % 0 == test_subject.skipped());
+    expect(that % static_cast<bool>(test_subject.stop()));
+    expect(!timer.callback);
+  };
+
+  should("fixed_rate_runner overrun with skip policy") = []() {
+    // Setup
+    fake_timer timer;
+    fixed_rate_runner test_subject(timer, 1_MHz);
+    std::uint32_t duration = 10;
+    auto callback = [&duration]() { advance(duration); };
+    expect(that % static_cast<bool>(test_subject.start(
+                    callback, 100us, fixed_rate_runner::overrun_policy::skip)));
+
+    // Exercise
+    fire_at(timer, 0);
+    duration = 250;
+    fire_at(timer, 100);
+    duration = 10;
+    fire_at(timer, 352);
+
+    // Verify: the slot at 200 is dropped and the grid is kept
+    expect(that % 3 == test_subject.runs());
+    expect(that % 1 == test_subject.overrun_count());
+    expect(that % 150 == test_subject.overruns().max());
+    expect(that % 1 == test_subject.skipped());
+    expect(that % 52 == test_subject.worst_latency());
+  };
+
+  should("fixed_rate_runner overrun with catch up policy") = []() {
+    // Setup
+    fake_timer timer;
+    fixed_rate_runner test_subject(timer, 1_MHz);
+    std::uint32_t duration = 10;
+    auto callback = [&duration]() { advance(duration); };
+    expect(that % static_cast<bool>(test_subject.start(
+                    callback,
+                    100us,
+                    fixed_rate_runner::overrun_policy::catch_up)));
+
+    // Exercise
+    fire_at(timer, 0);
+    duration = 250;
+    fire_at(timer, 100);
+    duration = 10;
+    fire_at(timer, 352);
+
+    // Verify: the slot at 200 runs late, followed by the slot at 300
+    expect(that % 4 == test_subject.runs());
+    expect(that % 0 == test_subject.skipped());
+    expect(that % 2 == test_subject.overrun_count());
+    expect(that % 152 == test_subject.worst_latency());
+  };
+
+  should("fixed_rate_runner tick before its slot") = []() {
+    for (auto policy : { fixed_rate_runner::overrun_policy::skip,
+                         fixed_rate_runner::overrun_policy::catch_up }) {
+      // Setup
+      fake_timer timer;
+      fixed_rate_runner test_subject(timer, 1_MHz);
+      auto callback = []() { advance(10); };
+      expect(that % static_cast<bool>(
+                      test_subject.start(callback, 100us, policy)));
+
+      // Exercise
+      fire_at(timer, 1'005);
+      fire_at(timer, 1'101);
+      fire_at(timer, 1'207);
+
+      // Verify: the early tick runs the slot at 1105 and the grid is kept
+      expect(that % 3 == test_subject.runs());
+      expect(that % 0 == test_subject.skipped());
+      expect(that % 0 == test_subject.overrun_count());
+      expect(that % 2 == test_subject.worst_latency());
+    }
+  };
+
+  should("fixed_rate_runner catch up is bounded") = []() {
+    // Setup
+    fake_timer timer;
+    fixed_rate_runner test_subject(timer, 1_MHz);
+    static constexpr std::uint32_t missed = 20;
+    auto callback = []() {};
+    expect(that % static_cast<bool>(test_subject.start(
+                    callback,
+                    100us,
+                    fixed_rate_runner::overrun_policy::catch_up)));
+
+    // Exercise
+    fire_at(timer, 0);
+    fire_at(timer, 100 * (missed + 1));
+
+    // Verify
+    expect(that % (1 + fixed_rate_runner::max_catch_up) ==
+           test_subject.runs());
+    expect(that % (missed + 1 - fixed_rate_runner::max_catch_up) ==
+           test_subject.skipped());
+  };
+};
+}  // namespace embed::cortex_m
@@ -0,0 +1,69 @@
+#include <thread>
+#include <vector>
+
+#include <boost/ut.hpp>
+#include <libarmcortex/histogram.hpp>
+
+namespace embed::cortex_m {
+boost::ut::suite histogram_test = []() {
+  using namespace boost::ut;
+
+  should("histogram::record()") = []() {
+    // Setup
+    histogram<4> test_subject(10);
+
+    // Exercise
+    test_subject.record(0);
+    test_subject.record(9);
+    test_subject.record(10);
+    test_subject.record(35);
+    test_subject.record(1'000);
+
+    // Verify
+    expect(that % 10 == test_subject.bucket_width());
+    expect(that % 4 == test_subject.size());
+    expect(that % 2 == test_subject.count(0));
+    expect(that % 1 == test_subject.count(1));
+    expect(that % 0 == test_subject.count(2));
+    expect(that % 2 == test_subject.count(3));
+    expect(that % 5 == test_subject.total());
+    expect(that % 1'000 == test_subject.max());
+  };
+
+  should("histogram::reset()") = []() {
+    // Setup
+    histogram<2> test_subject(1);
+    test_subject.record(1);
+
+    // Exercise
+    test_subject.reset();
+
+    // Verify
+    expect(that % 0 == test_subject.total());
+    expect(that % 0 == test_subject.max());
+  };
+
+  should("histogram::record() from concurrent writers") = []() {
+    // Setup
+    static constexpr std::uint32_t per_writer = 2'000;
+    histogram<8> test_subject(100);
+    std::vector<std::thread> writers;
+
+    // Exercise
+    for (std::uint32_t w = 0; w < 3; w++) {
+      writers.emplace_back([&test_subject, w]() {
+        for (std::uint32_t i = 0; i < per_writer; i++) {
+          test_subject.record(i + w);
+        }
+      });
+    }
+    for (auto& writer : writers) {
+      writer.join();
+    }
+
+    // Verify
+    expect(that % (3 * per_writer) == test_subject.total());
+    expect(that % (per_writer + 1) == test_subject.max());
+  };
+};
+}  // namespace embed::cortex_m
@@ -1,7 +1,63 @@
+#include <atomic>
+#include <string>
+#include <thread>
+
 #include <boost/ut.hpp>
 #include <libarmcortex/interrupt.hpp>
 
 namespace embed::cortex_m {
+namespace {
+std::string hook_calls;
+
+template<char Name>
+struct recording_hook
+{
+  static void enter(int p_irq)
+  {
+    hook_calls += Name;
+    hook_calls += std::to_string(p_irq);
+  }
+  static void exit(int p_irq)
+  {
+    hook_calls += static_cast<char>(Name - 'a' + 'A');
+    hook_calls += std::to_string(p_irq);
+  }
+};
+
+void recording_handler()
+{
+  hook_calls += "|";
+}
+
+bool source_a_fired = false;
+bool source_b_fired = false;
+void source_a_handler()
+{
+  hook_calls += "a";
+}
+void source_b_handler()
+{
+  hook_calls += "b";
+}
+void source_c_handler()
+{
+  hook_calls += "c";
+}
+bool zero_latency_active = false;
+void zero_latency_handler()
+{
+  zero_latency_active = critical_section::zero_latency_context::active();
+}
+bool source_a_check()
+{
+  return source_a_fired;
+}
+bool source_b_check()
+{
+  return source_b_fired;
+}
+}  // namespace
+
 boost::ut::suite interrupt_test = [] {
   using namespace boost::ut;
 
@@ -207,5 +263,260 @@ boost::ut::suite interrupt_test = [] {
     expect(that % interrupt::vector_table.size() ==
            interrupt::get_vector_table().size());
   };
+
+  should("interrupt::disable() masks before removing handler") = [&] {
+    // Setup
+    static constexpr int expected_irq = 12;
+    interrupt::nvic()->icer.at(0) = 0;
+    expect(that % static_cast<bool>(interrupt(expected_irq).enable(
+                    []() { hook_calls += "x"; })));
+
+    // Exercise
+    expect(that % static_cast<bool>(interrupt(expected_irq).disable()));
+
+    // Verify
+    expect((1U << expected_irq) & interrupt::nvic()->icer.at(0));
+    expect(interrupt::nop ==
+           interrupt::vector_table[interrupt::core_interrupts + expected_irq]);
+  };
+
+  should("interrupt::replace()") = [&] {
+    // Setup
+    static constexpr int expected_irq = 13;
+    interrupt_pointer fast_path = []() { hook_calls += "f"; };
+    interrupt_pointer diagnostic_path = []() { hook_calls += "d"; };
+    hook_calls.clear();
+    expect(that % static_cast<bool>(interrupt(expected_irq).enable(fast_path)));
+    interrupt::nvic()->iser.at(0) = 0;
+
+    // Exercise
+    interrupt::vector_table[interrupt::core_interrupts + expected_irq]();
+    const bool success =
+      static_cast<bool>(interrupt(expected_irq).replace(diagnostic_path));
+    interrupt::vector_table[interrupt::core_interrupts + expected_irq]();
+
+    // Verify: the handler is swapped and the enable state is untouched
+    expect(that % success);
+    expect(hook_calls == "fd");
+    expect(that % 0 == interrupt::nvic()->iser.at(0));
+    expect(that % !interrupt(-20).replace(diagnostic_path));
+  };
+
+  should("interrupt::replace() with drain") = [&] {
+    // Setup
+    static constexpr int expected_irq = 37;
+    static constexpr uint32_t active_bit = 1U << (expected_irq & 0x1F);
+    std::atomic<bool> drained = false;
+    interrupt::nvic()->iabr.at(1) = active_bit;
+
+    // Exercise: the old handler is still active until the other thread
+    // clears the active bit, as the hardware would on exception return.
+    std::thread replacer([&drained]() {
+      const auto result =
+        interrupt(expected_irq).replace(interrupt::nop, true);
+      drained = static_cast<bool>(result);
+    });
+    std::this_thread::yield();
+    const bool drained_early = drained;
+    interrupt::nvic()->iabr.at(1) = 0;
+    replacer.join();
+
+    // Verify
+    expect(that % !drained_early);
+    expect(that % drained.load());
+    expect(interrupt::nop ==
+           interrupt::vector_table[interrupt::core_interrupts + expected_irq]);
+  };
+
+  should("interrupt::drain() from within own handler") = [&] {
+    // Setup
+    static constexpr int expected_irq = 4;
+    interrupt::nvic()->iabr.at(0) = 1U << expected_irq;
+    system_control::scb()->icsr =
+      static_cast<uint32_t>(expected_irq + interrupt::core_interrupts);
+
+    // Exercise
+    const bool success = static_cast<bool>(interrupt(expected_irq).drain());
+    system_control::scb()->icsr = 0;
+    interrupt::nvic()->iabr.at(0) = 0;
+
+    // Verify: returns rather than waiting on itself
+    expect(that % success);
+  };
+
+  should("interrupt::mask() and interrupt::unmask()") = [&] {
+    // Setup
+    static constexpr int expected_irq = 14;
+    interrupt_pointer handler = []() { hook_calls += "m"; };
+    expect(that % static_cast<bool>(interrupt(expected_irq).enable(handler)));
+    interrupt::nvic()->iser.at(0) = 0;
+    interrupt::nvic()->icer.at(0) = 0;
+
+    // Exercise
+    const bool masked = static_cast<bool>(interrupt(expected_irq).mask());
+    const auto cleared = interrupt::nvic()->icer.at(0);
+    const bool unmasked = static_cast<bool>(interrupt(expected_irq).unmask());
+
+    // Verify: the enable state changes but the handler is kept
+    expect(that % masked);
+    expect(that % unmasked);
+    expect(that % (1U << expected_irq) == cleared);
+    expect(that % (1U << expected_irq) == interrupt::nvic()->iser.at(0));
+    expect(handler ==
+           interrupt::vector_table[interrupt::core_interrupts + expected_irq]);
+    expect(that % !interrupt(-20).mask());
+  };
+
+  should("interrupt::pend()") = [&] {
+    // Setup
+    interrupt::nvic()->stir = 0;
+
+    // Exercise
+    const bool pended = static_cast<bool>(interrupt(17).pend());
+    const auto requested = interrupt::nvic()->stir;
+    const bool pendsv_pended = static_cast<bool>(interrupt(-2).pend());
+    const bool out_of_bounds = static_cast<bool>(interrupt(1'000).pend());
+
+    // Verify
+    expect(that % pended);
+    expect(that % 17 == requested);
+    expect(that % !pendsv_pended);
+    expect(that % !out_of_bounds);
+  };
+
+  should("interrupt::set_priority()") = [&] {
+    // Setup
+    // Exercise
+    const bool irq_set = static_cast<bool>(interrupt(21).set_priority(0xA0));
+    const bool pendsv_set = static_cast<bool>(interrupt(-2).set_priority(0xF0));
+    const bool hard_fault_set =
+      static_cast<bool>(interrupt(-13).set_priority(0x10));
+
+    // Verify
+    expect(that % irq_set);
+    expect(that % pendsv_set);
+    expect(that % !hard_fault_set);
+    expect(that % 0xA0 == interrupt::nvic()->ip[21]);
+    expect(that % 0xF0 == system_control::scb()->shp[10]);
+    interrupt::nvic()->ip[21] = 0;
+    system_control::scb()->shp[10] = 0;
+  };
+
+  should("interrupt::basic_zero_latency") = [&] {
+    // Setup
+    using motor = interrupt::basic_zero_latency<0x40, 3, 8>;
+
+    // Exercise
+    const bool configured =
+      static_cast<bool>(motor::set_priority<0x10>());
+    interrupt::trampoline<zero_latency_handler, motor>();
+
+    // Verify
+    expect(that % motor::contains(3));
+    expect(that % motor::contains(8));
+    expect(that % !motor::contains(4));
+    expect(that % configured);
+    expect(that % 0x10 == interrupt::nvic()->ip[3]);
+    expect(that % 0x10 == interrupt::nvic()->ip[8]);
+    expect(that % zero_latency_active);
+    expect(that % !critical_section::zero_latency_context::active());
+    interrupt::nvic()->ip[3] = 0;
+    interrupt::nvic()->ip[8] = 0;
+  };
+
+  should("interrupt::trampoline()") = [&] {
+    // Setup
+    static constexpr int expected_irq = 7;
+    hook_calls.clear();
+    system_control::scb()->icsr =
+      static_cast<uint32_t>(expected_irq + interrupt::core_interrupts);
+
+    // Exercise
+    interrupt::trampoline<recording_handler>();
+    interrupt::trampoline<recording_handler,
+                          recording_hook<'a'>,
+                          recording_hook<'b'>>();
+    system_control::scb()->icsr = 0;
+
+    // Verify
+    expect(hook_calls == "|a7b7|B7A7");
+  };
+
+  should("interrupt::chain()") = [&] {
+    // Setup
+    hook_calls.clear();
+    source_a_fired = false;
+    source_b_fired = true;
+    interrupt_pointer dispatcher = interrupt::chain<
+      interrupt::shared_source<source_a_handler, source_a_check>,
+      interrupt::shared_source<source_b_handler, source_b_check>,
+      interrupt::shared_source<source_c_handler>>;
+
+    // Exercise
+    dispatcher();
+    source_a_fired = true;
+    dispatcher();
+
+    // Verify
+    expect(hook_calls == "bcabc");
+  };
+
+  should("interrupt::attach()") = [&] {
+    // Setup
+    static constexpr int expected_irq = 9;
+    static constexpr size_t capacity = 2;
+    interrupt::reinitialize<expected_interrupt_count>();
+    hook_calls.clear();
+    source_a_fired = true;
+    source_b_fired = false;
+    const auto vector = static_cast<size_t>(interrupt::core_interrupts +
+                                            expected_irq);
+
+    // Exercise
+    const bool first = static_cast<bool>(
+      interrupt::attach<expected_irq, capacity>(source_a_handler,
+                                                source_a_check));
+    const auto dispatcher = interrupt::vector_table[vector];
+    const bool second = static_cast<bool>(
+      interrupt::attach<expected_irq, capacity>(source_b_handler,
+                                                source_b_check));
+    const bool third = static_cast<bool>(
+      interrupt::attach<expected_irq, capacity>(source_c_handler));
+    interrupt::vector_table[vector]();
+    source_b_fired = true;
+    interrupt::vector_table[vector]();
+
+    // Verify
+    expect(that % first);
+    expect(that % second);
+    expect(dispatcher == interrupt::vector_table[vector]);
+    expect(interrupt::nop != dispatcher);
+    expect((1U << expected_irq) & interrupt::nvic()->iser.at(0));
+    expect(that % !third);
+    expect(hook_calls == "aab");
+  };
+
+  should("interrupt::attach() with another capacity") = [&] {
+    // Setup
+    static constexpr int expected_irq = 10;
+    interrupt::reinitialize<expected_interrupt_count>();
+    const auto vector = static_cast<size_t>(interrupt::core_interrupts +
+                                            expected_irq);
+    const bool first = static_cast<bool>(
+      interrupt::attach<expected_irq, 2>(source_a_handler));
+    const auto dispatcher = interrupt::vector_table[vector];
+
+    // Exercise
+    const bool second = static_cast<bool>(
+      interrupt::attach<expected_irq, 4>(source_b_handler));
+    const bool third = static_cast<bool>(
+      interrupt::attach<expected_irq, 2>(source_b_handler));
+
+    // Verify: the installed dispatcher is kept
+    expect(that % first);
+    expect(that % !second);
+    expect(that % third);
+    expect(dispatcher == interrupt::vector_table[vector]);
+  };
 };
 }
@@ -0,0 +1,114 @@
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <boost/ut.hpp>
+#include <libarmcortex/isr_budget.hpp>
+
+namespace embed::cortex_m {
+namespace {
+std::uint32_t handler_cycles = 0;
+std::vector<std::pair<int, std::uint32_t>> overrun_calls;
+
+struct recording_overrun
+{
+  static void overrun(int p_irq, std::uint32_t p_cycles) noexcept
+  {
+    overrun_calls.emplace_back(p_irq, p_cycles);
+  }
+};
+
+using budget = isr_budget<100, recording_overrun>;
+
+void busy_handler()
+{
+  dwt_counter::dwt()->cyccnt = dwt_counter::dwt()->cyccnt + handler_cycles;
+}
+
+void nested_handler()
+{
+  // Preempted by a handler sharing the same budget type
+  dwt_counter::dwt()->cyccnt = dwt_counter::dwt()->cyccnt + 10;
+  interrupt::trampoline<busy_handler, budget>();
+  dwt_counter::dwt()->cyccnt = dwt_counter::dwt()->cyccnt + 10;
+}
+
+void run_as(int p_irq, interrupt_pointer p_handler)
+{
+  system_control::scb()->icsr =
+    static_cast<std::uint32_t>(p_irq + interrupt::core_interrupts);
+  p_handler();
+  system_control::scb()->icsr = 0;
+}
+}  // namespace
+
+boost::ut::suite isr_budget_test = []() {
+  using namespace boost::ut;
+
+  static constexpr size_t interrupt_count = 42;
+  interrupt::reinitialize<interrupt_count>();
+
+  should("isr_budget within budget") = []() {
+    // Setup
+    budget::reset();
+    overrun_calls.clear();
+    handler_cycles = 100;
+
+    // Exercise
+    run_as(5, interrupt::trampoline<busy_handler, budget>);
+
+    // Verify
+    expect(that % 0 == budget::overruns());
+    expect(overrun_calls.empty());
+  };
+
+  should("isr_budget overrun") = []() {
+    // Setup
+    budget::reset();
+    overrun_calls.clear();
+    dwt_counter::dwt()->cyccnt = 0xFFFF'FFC0;
+    handler_cycles = 150;
+
+    // Exercise
+    run_as(5, interrupt::trampoline<busy_handler, budget>);
+
+    // Verify
+    expect(that % 1 == budget::overruns());
+    expect(that % 150 == budget::worst_overrun());
+    expect(that % 1 == overrun_calls.size());
+    expect(that % 5 == overrun_calls[0].first);
+    expect(that % 150 == overrun_calls[0].second);
+  };
+
+  should("isr_budget nested") = []() {
+    // Setup
+    budget::reset();
+    overrun_calls.clear();
+    handler_cycles = 90;
+
+    // Exercise: the inner handler is within budget, but the outer one is
+    // delayed past its own by the preemption
+    run_as(6, interrupt::trampoline<nested_handler, budget>);
+
+    // Verify
+    expect(that % 1 == budget::overruns());
+    expect(that % 1 == overrun_calls.size());
+    expect(that % 110 == overrun_calls[0].second);
+  };
+
+  should("isr_budget with mask_on_overrun") = []() {
+    // Setup
+    static constexpr int irq = 7;
+    using masking_budget = isr_budget<10, mask_on_overrun>;
+    interrupt::nvic()->icer.at(0) = 0;
+    handler_cycles = 11;
+
+    // Exercise
+    run_as(irq, interrupt::trampoline<busy_handler, masking_budget>);
+
+    // Verify
+    expect(that % 1 == masking_budget::overruns());
+    expect(that % (1U << irq) == interrupt::nvic()->icer.at(0));
+  };
+};
+}  // namespace embed::cortex_m
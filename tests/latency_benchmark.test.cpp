@@ -0,0 +1,104 @@
+#include <array>
+#include <string_view>
+
+#include <boost/ut.hpp>
+#include <libarmcortex/latency_benchmark.hpp>
+
+namespace embed::cortex_m {
+boost::ut::suite latency_benchmark_test = []() {
+  using namespace boost::ut;
+
+  static constexpr size_t interrupt_count = 42;
+  using benchmark = latency_benchmark<interrupt_count, 30, 31>;
+
+  interrupt::reinitialize<interrupt_count>();
+
+  should("latency_benchmark::run()") = []() {
+    // Setup
+    auto* ram_table = system_control().get_interrupt_vector_table_address();
+    interrupt::nvic()->ip[30] = 0x10;
+    system_control::fpu()->fpccr = 0x1234;
+    std::array<latency_result, latency_scenario_count> results{};
+
+    // Exercise
+    auto count = benchmark::run(results, 3);
+
+    // Verify: every scenario reached its handler; the host has no cycles to
+    // count
+    expect(that % static_cast<bool>(count));
+    expect(that % latency_scenario_count == count.value());
+    for (std::size_t i = 0; i < results.size(); i++) {
+      expect(that % i == static_cast<std::size_t>(results[i].scenario));
+      expect(that % 3 == results[i].samples);
+      expect(that % 0 == results[i].min);
+      expect(that % 0 == results[i].max);
+    }
+    expect(that % 31 == interrupt::nvic()->stir);
+    expect(ram_table == system_control().get_interrupt_vector_table_address());
+    expect(that % 0x10 == interrupt::nvic()->ip[30]);
+    expect(that % 0 == interrupt::nvic()->ip[31]);
+    expect(that % 0x1234 == system_control::fpu()->fpccr);
+  };
+
+  should("latency_benchmark priorities are masked by critical sections") =
+    []() {
+      // Verify: both IRQs are masked by a critical section, and HighIrq
+      // preempts LowIrq
+      expect(that % benchmark::high_priority >= config::zero_latency_threshold);
+      expect(that % benchmark::high_priority < benchmark::low_priority);
+      expect(that % 0 == (benchmark::high_priority & 0x3F));
+    };
+
+  should("latency_benchmark::simulate()") = []() {
+    // Setup
+    std::array<latency_result, latency_scenario_count> results{};
+
+    // Exercise
+    const auto count =
+      benchmark::simulate({ .flash_wait_states = 5 }, results);
+
+    // Verify
+    expect(that % latency_scenario_count == count);
+    expect(that % 12 == results[0].min);
+    expect(that % 17 == results[1].min);
+    expect(that % 12 == results[2].min);
+    expect(that % 29 == results[3].min);
+    expect(that % 6 == results[4].min);
+    expect(that % 12 == results[5].min);
+    expect(that % 1 == results[5].samples);
+  };
+
+  should("write_csv()") = []() {
+    // Setup
+    const std::array<latency_result, 2> results{
+      latency_result{ .scenario = latency_scenario::tail_chain,
+                      .min = 6,
+                      .max = 9,
+                      .samples = 16 },
+      latency_result{ .scenario = latency_scenario::nested_preemption,
+                      .min = 12,
+                      .max = 14,
+                      .samples = 16 },
+    };
+    std::array<char, 128> buffer{};
+    std::array<char, 32> small{};
+
+    // Exercise
+    const auto length = write_csv(results, buffer);
+    const auto truncated = write_csv(results, small);
+
+    // Verify
+    expect(std::string_view(buffer.data(), length) ==
+           "scenario,min,max,samples\n"
+           "tail_chain,6,9,16\n"
+           "nested_preemption,12,14,16\n");
+    expect(that % (small.size() - 1) == truncated);
+    expect(that % '\0' == small.back());
+  };
+
+  // Teardown: leave the vector table uninitialized for other test suites
+  interrupt::reinitialize<interrupt_count>();
+  interrupt::vector_table = {};
+  system_control().set_interrupt_vector_table_address(nullptr);
+};
+}  // namespace embed::cortex_m
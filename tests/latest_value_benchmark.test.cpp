@@ -0,0 +1,42 @@
+#include <array>
+#include <string_view>
+
+#include <boost/ut.hpp>
+#include <libarmcortex/latest_value_benchmark.hpp>
+
+namespace embed::cortex_m {
+boost::ut::suite latest_value_benchmark_test = []() {
+  using namespace boost::ut;
+
+  should("benchmark_latest_value()") = []() {
+    // Setup
+    std::array<operation_cost, latest_value_operation_count> results{};
+
+    // Exercise
+    const auto count = benchmark_latest_value(results, 2);
+
+    // Verify: the host cycle counter does not advance
+    expect(that % latest_value_operation_count == count);
+    expect(std::string_view(results[0].operation) == "seqlock::write");
+    expect(std::string_view(results[1].operation) == "seqlock::read");
+    expect(std::string_view(results[2].operation) == "triple_buffer::publish");
+    expect(std::string_view(results[3].operation) == "triple_buffer::update");
+    expect(std::string_view(results[4].operation) == "critical_section read");
+    for (const auto& result : results) {
+      expect(that % 0 == result.cycles);
+    }
+  };
+
+  should("benchmark_latest_value() with fewer results") = []() {
+    // Setup
+    std::array<operation_cost, 1> results{};
+
+    // Exercise
+    const auto count = benchmark_latest_value(results);
+
+    // Verify
+    expect(that % 1 == count);
+    expect(std::string_view(results[0].operation) == "seqlock::write");
+  };
+};
+}  // namespace embed::cortex_m
@@ -0,0 +1,43 @@
+#include <array>
+#include <string_view>
+
+#include <boost/ut.hpp>
+#include <libarmcortex/log_benchmark.hpp>
+
+namespace embed::cortex_m {
+boost::ut::suite log_benchmark_test = []() {
+  using namespace boost::ut;
+
+  should("benchmark_logging()") = []() {
+    // Setup
+    std::array<operation_cost, log_operation_count> results{};
+
+    // Exercise
+    const auto count = benchmark_logging(results, 2);
+
+    // Verify: the host cycle counter does not advance
+    expect(that % log_operation_count == count);
+    expect(std::string_view(results[0].operation) ==
+           "LIBARMCORTEX_LOG no arguments");
+    expect(std::string_view(results[2].operation) ==
+           "LIBARMCORTEX_LOG 4 arguments");
+    expect(std::string_view(results[3].operation) == "snprintf 2 arguments");
+    for (const auto& result : results) {
+      expect(that % 0 == result.cycles);
+    }
+  };
+
+  should("benchmark_logging() with fewer results") = []() {
+    // Setup
+    std::array<operation_cost, 2> results{};
+
+    // Exercise
+    const auto count = benchmark_logging(results);
+
+    // Verify
+    expect(that % 2 == count);
+    expect(std::string_view(results[1].operation) ==
+           "LIBARMCORTEX_LOG 2 arguments");
+  };
+};
+}  // namespace embed::cortex_m
@@ -0,0 +1,124 @@
+#include <array>
+#include <thread>
+#include <vector>
+
+#include <boost/ut.hpp>
+#include <libarmcortex/mpsc_queue.hpp>
+
+namespace embed::cortex_m {
+boost::ut::suite mpsc_queue_test = []() {
+  using namespace boost::ut;
+
+  should("mpsc_queue::push() & mpsc_queue::pop()") = []() {
+    // Setup
+    mpsc_queue<int, 4> test_subject;
+
+    // Exercise & Verify
+    expect(that % test_subject.empty());
+    expect(!test_subject.pop().has_value());
+    expect(that % test_subject.push(1));
+    expect(that % test_subject.push(2));
+    expect(that % test_subject.push(3));
+    expect(that % test_subject.push(4));
+    expect(that % !test_subject.push(5));
+    expect(that % 1 == test_subject.pop().value());
+    expect(that % test_subject.push(5));
+    expect(that % 2 == test_subject.pop().value());
+    expect(that % 3 == test_subject.pop().value());
+    expect(that % 4 == test_subject.pop().value());
+    expect(that % 5 == test_subject.pop().value());
+    expect(!test_subject.pop().has_value());
+  };
+
+  should("mpsc_queue::push(span) & mpsc_queue::pop(span)") = []() {
+    // Setup
+    mpsc_queue<int, 8> test_subject;
+    std::array<int, 5> input{ 1, 2, 3, 4, 5 };
+    std::array<int, 8> output{};
+
+    // Exercise & Verify
+    expect(that % 5 == test_subject.push(input));
+    expect(that % 3 == test_subject.push(input));
+    expect(that % 0 == test_subject.push(input));
+    expect(that % 8 == test_subject.pop(output));
+    expect(that % 5 == output[4]);
+    expect(that % 3 == output[7]);
+    expect(that % 0 == test_subject.pop(output));
+  };
+
+  should("mpsc_queue::push_all()") = []() {
+    // Setup
+    mpsc_queue<int, 8> test_subject;
+    std::array<int, 5> input{ 1, 2, 3, 4, 5 };
+    std::array<int, 8> output{};
+
+    // Exercise & Verify
+    expect(that % test_subject.push_all(input));
+    // Verify: a record that does not fit is not truncated
+    expect(that % !test_subject.push_all(input));
+    expect(that % 5 == test_subject.size());
+    expect(that % test_subject.push_all(std::span(input).first(3)));
+    expect(that % 8 == test_subject.pop(output));
+    expect(that % 3 == output[7]);
+  };
+
+  should("mpsc_queue stress: thread producers (ISRs) & consumer") = []() {
+    // Setup
+    static constexpr std::uint32_t producer_count = 4;
+    static constexpr std::uint32_t per_producer = 20'000;
+    static mpsc_queue<std::uint32_t, 32> test_subject;
+    std::array<std::uint32_t, producer_count> next_expected{};
+    bool in_order = true;
+
+    // Exercise
+    // Each element holds the producer id in the upper byte and a sequence
+    // number below it. Producers alternate between single and batched pushes.
+    std::vector<std::thread> producers;
+    for (std::uint32_t id = 0; id < producer_count; id++) {
+      producers.emplace_back([id]() {
+        std::uint32_t sequence = 0;
+        while (sequence < per_producer) {
+          std::array<std::uint32_t, 3> batch{};
+          for (std::uint32_t i = 0; i < batch.size(); i++) {
+            batch[i] = (id << 24U) | (sequence + i);
+          }
+          auto length = (sequence % 2 == 0) ? 1U : batch.size();
+          length = std::min<std::size_t>(length, per_producer - sequence);
+          auto pushed = test_subject.push(std::span(batch).first(length));
+          if (pushed == 0) {
+            std::this_thread::yield();
+          }
+          sequence += static_cast<std::uint32_t>(pushed);
+        }
+      });
+    }
+
+    std::uint32_t received = 0;
+    std::array<std::uint32_t, 4> output{};
+    while (received < producer_count * per_producer) {
+      auto count = test_subject.pop(output);
+      if (count == 0) {
+        std::this_thread::yield();
+      }
+      for (std::size_t i = 0; i < count; i++) {
+        auto id = output[i] >> 24U;
+        auto sequence = output[i] & 0xFF'FFFFU;
+        in_order = in_order && (sequence == next_expected[id]);
+        next_expected[id]++;
+        received++;
+      }
+    }
+
+    for (auto& producer : producers) {
+      producer.join();
+    }
+
+    // Verify
+    expect(that % in_order);
+    expect(that % test_subject.empty());
+    for (auto count : next_expected) {
+      expect(that % per_producer == count);
+    }
+  };
+};
+}  // namespace embed::cortex_m
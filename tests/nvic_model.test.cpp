@@ -0,0 +1,203 @@
+#include <array>
+#include <utility>
+#include <vector>
+
+#include <boost/ut.hpp>
+#include <libarmcortex/nvic_model.hpp>
+
+namespace embed::cortex_m {
+namespace {
+std::vector<std::pair<int, std::uint32_t>> handler_calls;
+
+void recording_handler()
+{
+  handler_calls.emplace_back(interrupt::active_irq(),
+                             dwt_counter::dwt()->cyccnt);
+}
+}  // namespace
+
+boost::ut::suite nvic_model_test = []() {
+  using namespace boost::ut;
+
+  static constexpr size_t interrupt_count = 42;
+
+  interrupt::initialize<interrupt_count>();
+
+  should("nvic_model::replay()") = [] {
+    // Setup
+    nvic_model test_subject(10);
+    handler_calls.clear();
+    interrupt::nvic()->ip[1] = 0x80;
+    interrupt::nvic()->ip[2] = 0x20;
+    interrupt::nvic()->ip[3] = 0x90;
+    for (int irq : { 1, 2, 3 }) {
+      interrupt::vector_table[static_cast<size_t>(
+        irq + interrupt::core_interrupts)] = recording_handler;
+    }
+    test_subject.configure(1, { .service_cycles = 100, .deadline_cycles = 0 });
+    test_subject.configure(2, { .service_cycles = 50, .deadline_cycles = 60 });
+    test_subject.configure(3, { .service_cycles = 5, .deadline_cycles = 0 });
+    const std::array<nvic_model::arrival, 5> timeline{
+      nvic_model::arrival{ .cycle = 0, .irq = 1 },
+      nvic_model::arrival{ .cycle = 30, .irq = 2 },
+      nvic_model::arrival{ .cycle = 40, .irq = 2 },
+      nvic_model::arrival{ .cycle = 42, .irq = 3 },
+      nvic_model::arrival{ .cycle = 45, .irq = 2 },
+    };
+
+    // Exercise
+    const auto completions = test_subject.replay(timeline);
+
+    // Verify: IRQ 2 preempts IRQ 1 and its second arrival is serviced before
+    // IRQ 1 resumes, while lower priority IRQ 3 waits for IRQ 1 to finish.
+    expect(that % 4 == completions.size());
+    expect(that % 2 == completions[0].irq);
+    expect(that % 40 == completions[0].start);
+    expect(that % 90 == completions[0].finish);
+    expect(that % 2 == completions[1].irq);
+    expect(that % 40 == completions[1].arrival);
+    expect(that % 150 == completions[1].finish);
+    expect(that % 1 == completions[2].irq);
+    expect(that % 230 == completions[2].finish);
+    expect(that % 3 == completions[3].irq);
+    expect(that % 240 == completions[3].start);
+
+    const auto& irq2 = test_subject.statistics(2);
+    expect(that % 2 == irq2.count);
+    expect(that % 1 == irq2.lost);
+    expect(that % 1 == irq2.deadline_misses);
+    expect(that % 60 == irq2.max_latency);
+    expect(that % 110 == irq2.max_response);
+    expect(that % 230 == test_subject.statistics(1).max_response);
+    expect(that % 2 == test_subject.max_pending());
+
+    expect(that % 4 == handler_calls.size());
+    expect(std::pair(1, 10U) == handler_calls[0]);
+    expect(std::pair(2, 40U) == handler_calls[1]);
+    expect(std::pair(2, 100U) == handler_calls[2]);
+    expect(std::pair(3, 240U) == handler_calls[3]);
+    expect(that % 0 == system_control::scb()->icsr);
+  };
+
+  should("nvic_model::set_tail_chain_cycles()") = [] {
+    // Setup
+    nvic_model test_subject(12);
+    test_subject.set_tail_chain_cycles(6);
+    interrupt::nvic()->ip[1] = 0x80;
+    interrupt::nvic()->ip[2] = 0x20;
+    test_subject.configure(1, { .service_cycles = 10, .deadline_cycles = 0 });
+    test_subject.configure(2, { .service_cycles = 30, .deadline_cycles = 0 });
+    const std::array<nvic_model::arrival, 3> timeline{
+      nvic_model::arrival{ .cycle = 0, .irq = 2 },
+      nvic_model::arrival{ .cycle = 5, .irq = 1 },
+      nvic_model::arrival{ .cycle = 100, .irq = 1 },
+    };
+
+    // Exercise
+    const auto completions = test_subject.replay(timeline);
+
+    // Verify: IRQ 1 is pending when IRQ 2 returns and is tail-chained, but
+    // pays the full entry when it arrives while nothing is running
+    expect(that % 3 == completions.size());
+    expect(that % 42 == completions[0].finish);
+    expect(that % 48 == completions[1].start);
+    expect(that % 112 == completions[2].start);
+  };
+
+  should("nvic_model::replay() is deterministic") = [] {
+    // Setup
+    const std::array<nvic_model::arrival, 3> timeline{
+      nvic_model::arrival{ .cycle = 100, .irq = 1 },
+      nvic_model::arrival{ .cycle = 110, .irq = 2 },
+      nvic_model::arrival{ .cycle = 500, .irq = 1 },
+    };
+    nvic_model first;
+    nvic_model second;
+    for (auto* model : { &first, &second }) {
+      model->configure(1, { .service_cycles = 40, .deadline_cycles = 0 });
+      model->configure(2, { .service_cycles = 20, .deadline_cycles = 0 });
+    }
+
+    // Exercise
+    const auto a = first.replay(timeline);
+    const auto b = second.replay(timeline);
+
+    // Verify
+    expect(that % a.size() == b.size());
+    for (size_t i = 0; i < a.size(); i++) {
+      expect(that % a[i].irq == b[i].irq);
+      expect(that % a[i].start == b[i].start);
+      expect(that % a[i].finish == b[i].finish);
+    }
+  };
+
+  should("nvic_model::mask() zero latency benchmark") = [] {
+    // Setup: IRQ 1 is zero latency below a threshold of 0x40, IRQ 2 is not.
+    // Thread mode enters a 300 cycle critical section every 1000 cycles and
+    // both interrupts arrive at varying points within them.
+    static constexpr std::uint8_t threshold = 0x40;
+    interrupt::nvic()->ip[1] = 0x20;
+    interrupt::nvic()->ip[2] = 0x80;
+    std::vector<nvic_model::arrival> timeline;
+    for (std::uint64_t period = 0; period < 50; period++) {
+      const auto offset = (period * 37) % 300;
+      timeline.push_back({ .cycle = period * 1'000 + offset, .irq = 1 });
+      timeline.push_back({ .cycle = period * 1'000 + offset + 1, .irq = 2 });
+    }
+    auto run = [&timeline](std::uint8_t p_basepri) {
+      nvic_model model(12);
+      model.configure(1, { .service_cycles = 40, .deadline_cycles = 60 });
+      model.configure(2, { .service_cycles = 40, .deadline_cycles = 0 });
+      for (std::uint64_t period = 0; period < 50; period++) {
+        model.mask({ .start = period * 1'000,
+                     .end = period * 1'000 + 300,
+                     .basepri = p_basepri });
+      }
+      model.replay(timeline);
+      return std::pair(model.statistics(1), model.statistics(2));
+    };
+
+    // Exercise
+    const auto [zero_latency, masked] = run(threshold);
+    const auto [primask_zero_latency, primask_masked] = run(0);
+
+    // Verify: with BASEPRI the zero latency IRQ is only ever delayed by
+    // interrupt entry, while PRIMASK holds it off for the critical section.
+    expect(that % 50 == zero_latency.count);
+    expect(that % 12 == zero_latency.max_latency);
+    expect(that % 0 == zero_latency.deadline_misses);
+    expect(that % 200 < masked.max_latency);
+    expect(that % 200 < primask_zero_latency.max_latency);
+    expect(that % 0 < primask_zero_latency.deadline_misses);
+    expect(that % 50 == primask_masked.count);
+    interrupt::nvic()->ip[1] = 0;
+    interrupt::nvic()->ip[2] = 0;
+  };
+
+  should("nvic_model::arrivals_from_trace()") = [] {
+    // Setup
+    const std::array<trace_event, 4> events{
+      trace_event{ 0xFFFF'FFF0, trace_event_type::irq_enter, 4 },
+      trace_event{ 0xFFFF'FFF8, trace_event_type::irq_exit, 4 },
+      trace_event{ 0x0000'0010, trace_event_type::marker, 9 },
+      trace_event{ 0x0000'0020, trace_event_type::irq_enter, 6 },
+    };
+
+    // Exercise
+    const auto arrivals = nvic_model::arrivals_from_trace(events);
+
+    // Verify
+    expect(that % 2 == arrivals.size());
+    expect(that % 0 == arrivals[0].cycle);
+    expect(that % 4 == arrivals[0].irq);
+    expect(that % 0x30 == arrivals[1].cycle);
+    expect(that % 6 == arrivals[1].irq);
+  };
+
+  // Teardown: restore the default priorities and handlers
+  for (int irq : { 1, 2, 3 }) {
+    interrupt::nvic()->ip[static_cast<size_t>(irq)] = 0;
+  }
+  interrupt::reinitialize<interrupt_count>();
+};
+}  // namespace embed::cortex_m
@@ -0,0 +1,41 @@
+#include <array>
+#include <string_view>
+
+#include <boost/ut.hpp>
+#include <libarmcortex/queue_benchmark.hpp>
+
+namespace embed::cortex_m {
+boost::ut::suite queue_benchmark_test = []() {
+  using namespace boost::ut;
+
+  should("benchmark_queues()") = []() {
+    // Setup
+    std::array<operation_cost, queue_operation_count> results{};
+
+    // Exercise
+    const auto count = benchmark_queues(results, 2);
+
+    // Verify: the host cycle counter does not advance
+    expect(that % queue_operation_count == count);
+    expect(std::string_view(results[0].operation) == "spsc_queue::push");
+    expect(std::string_view(results[3].operation) == "spsc_queue::pop batch");
+    expect(std::string_view(results[4].operation) == "mpsc_queue::push");
+    expect(std::string_view(results[7].operation) == "mpsc_queue::pop batch");
+    for (const auto& result : results) {
+      expect(that % 0 == result.cycles);
+    }
+  };
+
+  should("benchmark_queues() with fewer results") = []() {
+    // Setup
+    std::array<operation_cost, 3> results{};
+
+    // Exercise
+    const auto count = benchmark_queues(results);
+
+    // Verify
+    expect(that % 3 == count);
+    expect(std::string_view(results[2].operation) == "spsc_queue::push batch");
+  };
+};
+}  // namespace embed::cortex_m
@@ -0,0 +1,49 @@
+#include <boost/ut.hpp>
+#include <libarmcortex/resume_latency.hpp>
+
+namespace embed::cortex_m {
+namespace {
+constexpr int resume_irq = 12;
+using benchmark = resume_latency<resume_irq>;
+}  // namespace
+
+boost::ut::suite resume_latency_test = []() {
+  using namespace boost::ut;
+
+  static constexpr size_t interrupt_count = 42;
+  interrupt::reinitialize<interrupt_count>();
+  coroutine_executor::initialize<4>();
+
+  should("resume_latency::measure()") = []() {
+    // Setup
+    interrupt::nvic()->stir = 0;
+    const auto frames = coroutine_executor::frames_available();
+
+    // Exercise
+    auto latency = benchmark::measure(4);
+
+    // Verify: the coroutine resumed for every sample and returned its frame;
+    // the host has no cycles to count
+    expect(that % static_cast<bool>(latency));
+    expect(that % 0 == latency.value());
+    expect(that % resume_irq == interrupt::nvic()->stir);
+    expect(that % frames == coroutine_executor::frames_available());
+    expect(interrupt::nop ==
+           interrupt::vector_table[interrupt::core_interrupts + resume_irq]);
+    expect(that % 0 == system_control::scb()->icsr);
+    expect(!coroutine_executor::run_once());
+  };
+
+  should("resume_latency::measure() with an invalid IRQ") = []() {
+    // Setup
+    const auto frames = coroutine_executor::frames_available();
+
+    // Exercise
+    auto latency = resume_latency<interrupt_count>::measure(4);
+
+    // Verify
+    expect(that % !static_cast<bool>(latency));
+    expect(that % frames == coroutine_executor::frames_available());
+  };
+};
+}  // namespace embed::cortex_m
@@ -0,0 +1,204 @@
+#include <array>
+#include <cstdint>
+
+#include <boost/ut.hpp>
+#include <libarmcortex/schedulability.hpp>
+#include <libarmcortex/schedulability_report.hpp>
+
+namespace embed::cortex_m {
+namespace {
+using monitor = wcet_monitor<42>;
+
+std::uint32_t inner_cycles = 0;
+
+void advance(std::uint32_t p_cycles)
+{
+  dwt_counter::dwt()->cyccnt = dwt_counter::dwt()->cyccnt + p_cycles;
+}
+
+void inner_handler()
+{
+  advance(inner_cycles);
+}
+
+void run_as(int p_irq, interrupt_pointer p_handler)
+{
+  const std::uint32_t previous = system_control::scb()->icsr;
+  system_control::scb()->icsr =
+    static_cast<std::uint32_t>(p_irq + interrupt::core_interrupts);
+  p_handler();
+  system_control::scb()->icsr = previous;
+}
+
+void outer_handler()
+{
+  advance(30);
+  // Preempted by IRQ 4
+  run_as(4, interrupt::trampoline<inner_handler, monitor>);
+  advance(20);
+}
+}  // namespace
+
+boost::ut::suite schedulability_test = []() {
+  using namespace boost::ut;
+
+  static constexpr size_t interrupt_count = 42;
+  interrupt::reinitialize<interrupt_count>();
+
+  should("wcet_monitor excludes nested handlers") = []() {
+    // Setup
+    monitor::reset();
+    inner_cycles = 100;
+
+    // Exercise
+    run_as(5, interrupt::trampoline<outer_handler, monitor>);
+    inner_cycles = 70;
+    run_as(4, interrupt::trampoline<inner_handler, monitor>);
+
+    // Verify
+    expect(that % 50 == monitor::wcet(5));
+    expect(that % 100 == monitor::wcet(4));
+    expect(that % 0 == monitor::wcet(6));
+  };
+
+  should("response_time_analysis()") = []() {
+    // Setup
+    std::array<irq_profile, 3> profiles{
+      irq_profile{ .irq = 5,
+                   .priority = 0x20,
+                   .min_interarrival = 400,
+                   .deadline = 0,
+                   .wcet = 100 },
+      irq_profile{ .irq = 6,
+                   .priority = 0x40,
+                   .min_interarrival = 600,
+                   .deadline = 0,
+                   .wcet = 200 },
+      irq_profile{ .irq = 7,
+                   .priority = 0x60,
+                   .min_interarrival = 1'200,
+                   .deadline = 0,
+                   .wcet = 300 },
+    };
+    std::array<irq_response, 3> responses{};
+
+    // Exercise
+    const bool schedulable = response_time_analysis(profiles, responses);
+    profiles[2].wcet = 600;
+    std::array<irq_response, 3> overloaded{};
+    const bool overloaded_schedulable =
+      response_time_analysis(profiles, overloaded);
+
+    // Verify
+    expect(that % schedulable);
+    expect(that % 100 == responses[0].response);
+    expect(that % 300 == responses[0].slack);
+    expect(that % 300 == responses[1].response);
+    expect(that % 1'000 == responses[2].response);
+    expect(that % 200 == responses[2].slack);
+    expect(that % !overloaded_schedulable);
+    expect(that % overloaded[1].schedulable);
+    expect(that % !overloaded[2].schedulable);
+    expect(that % 0 > overloaded[2].slack);
+  };
+
+  should("response_time_analysis() with equal priorities") = []() {
+    // Setup: IRQ 9 cannot preempt IRQ 8 but can be running when it arrives
+    const std::array<irq_profile, 2> profiles{
+      irq_profile{ .irq = 8,
+                   .priority = 0x20,
+                   .min_interarrival = 1'000,
+                   .deadline = 150,
+                   .wcet = 50 },
+      irq_profile{ .irq = 9,
+                   .priority = 0x20,
+                   .min_interarrival = 1'000,
+                   .deadline = 0,
+                   .wcet = 80 },
+    };
+    std::array<irq_response, 2> responses{};
+
+    // Exercise
+    const bool schedulable = response_time_analysis(profiles, responses, 10);
+
+    // Verify
+    expect(that % schedulable);
+    expect(that % 150 == responses[0].response);
+    expect(that % 0 == responses[0].slack);
+    expect(that % 150 == responses[1].response);
+  };
+
+  should("response_time_analysis() with subpriorities") = []() {
+    // Setup: with PRIGROUP at 5 only bits 7:6 are the group priority, so both
+    // IRQs are in group 0x40. IRQ 9 has the lower subpriority and is taken
+    // first when both are pending, but cannot preempt IRQ 8.
+    static constexpr std::uint8_t group_mask = 0xC0;
+    const std::array<irq_profile, 2> profiles{
+      irq_profile{ .irq = 8,
+                   .priority = 0x60,
+                   .min_interarrival = 1'000,
+                   .deadline = 0,
+                   .wcet = 50 },
+      irq_profile{ .irq = 9,
+                   .priority = 0x40,
+                   .min_interarrival = 1'000,
+                   .deadline = 0,
+                   .wcet = 80 },
+    };
+    std::array<irq_response, 2> grouped{};
+    std::array<irq_response, 2> ungrouped{};
+
+    // Exercise
+    const bool schedulable =
+      response_time_analysis(profiles, grouped, 10, group_mask);
+    (void)response_time_analysis(profiles, ungrouped, 10);
+
+    // Verify: IRQ 8 can be running when IRQ 9 arrives and blocks it
+    expect(that % schedulable);
+    expect(that % 150 == grouped[0].response);
+    expect(that % 150 == grouped[1].response);
+    expect(that % 90 == ungrouped[1].response);
+  };
+
+  should("wcet_monitor::profile() round trip through a dump") = []() {
+    // Setup
+    monitor::reset();
+    inner_cycles = 42;
+    interrupt::nvic()->ip[4] = 0x80;
+    system_control::scb()->shp[10] = 0xE0;
+    run_as(4, interrupt::trampoline<inner_handler, monitor>);
+    const std::array<irq_timing, 2> timing{
+      irq_timing{ .irq = 4, .min_interarrival = 1'000, .deadline = 500 },
+      irq_timing{ .irq = -2, .min_interarrival = 5'000, .deadline = 0 },
+    };
+    std::array<irq_profile, 2> profiles{};
+    std::array<std::uint32_t, 2 * irq_profile_words> words{};
+    std::array<irq_response, 2> responses{};
+
+    // Exercise
+    const bool profiled =
+      static_cast<bool>(monitor::profile(timing, profiles));
+    const auto written = dump_profiles(profiles, words);
+    const auto decoded = decode_profiles(words);
+    response_time_analysis(decoded, responses);
+    const auto report = to_report(responses);
+
+    // Verify
+    expect(that % profiled);
+    expect(that % words.size() == written);
+    expect(that % 2 == decoded.size());
+    expect(that % 4 == decoded[0].irq);
+    expect(that % 0x80 == decoded[0].priority);
+    expect(that % 42 == decoded[0].wcet);
+    expect(that % 500 == decoded[0].deadline);
+    expect(that % -2 == decoded[1].irq);
+    expect(that % 0xE0 == decoded[1].priority);
+    expect(that % 5'000 == decoded[1].min_interarrival);
+    expect(report == "irq,response,slack,schedulable\n"
+                     "4,42,458,yes\n"
+                     "-2,0,5000,yes\n");
+    interrupt::nvic()->ip[4] = 0;
+    system_control::scb()->shp[10] = 0;
+  };
+};
+}  // namespace embed::cortex_m
@@ -0,0 +1,88 @@
+#include <atomic>
+#include <thread>
+
+#include <boost/ut.hpp>
+#include <libarmcortex/seqlock.hpp>
+
+namespace embed::cortex_m {
+boost::ut::suite seqlock_test = []() {
+  using namespace boost::ut;
+
+  struct reading_t
+  {
+    std::uint32_t sample;
+    std::uint64_t timestamp;
+    std::uint16_t checksum;
+  };
+
+  should("seqlock::write() & seqlock::read()") = []() {
+    // Setup
+    seqlock<reading_t> test_subject;
+
+    // Exercise & Verify
+    expect(that % 0 == test_subject.version());
+    expect(that % 0 == test_subject.read().sample);
+
+    test_subject.write(
+      { .sample = 5, .timestamp = 0x1'0000'0002, .checksum = 7 });
+    auto reading = test_subject.read();
+    expect(that % 1 == test_subject.version());
+    expect(that % 5 == reading.sample);
+    expect(that % 0x1'0000'0002 == reading.timestamp);
+    expect(that % 7 == reading.checksum);
+
+    test_subject.write({ .sample = 9, .timestamp = 3, .checksum = 2 });
+    auto second_reading = test_subject.try_read();
+    expect(that % 2 == test_subject.version());
+    expect(that % second_reading.has_value());
+    expect(that % 9 == second_reading->sample);
+  };
+
+  should("seqlock stress: thread writer (ISR) & reader") = []() {
+    // Setup
+    static constexpr std::uint32_t total = 100'000;
+    static seqlock<reading_t> test_subject;
+    static std::atomic<bool> done = false;
+    bool consistent = true;
+    bool monotonic = true;
+    std::uint32_t reads = 0;
+
+    // Exercise
+    std::thread writer([]() {
+      for (std::uint32_t i = 1; i <= total; i++) {
+        test_subject.write({
+          .sample = i,
+          .timestamp = (std::uint64_t{ i } << 32U) | i,
+          .checksum = static_cast<std::uint16_t>(i * 3U),
+        });
+        if (i % 64 == 0) {
+          std::this_thread::yield();
+        }
+      }
+      done = true;
+    });
+
+    std::uint32_t previous = 0;
+    while (!done) {
+      auto reading = test_subject.read();
+      const auto expected_timestamp =
+        (std::uint64_t{ reading.sample } << 32U) | reading.sample;
+      const auto expected_checksum =
+        static_cast<std::uint16_t>(reading.sample * 3U);
+      consistent = consistent && reading.timestamp == expected_timestamp &&
+                   reading.checksum == expected_checksum;
+      monotonic = monotonic && reading.sample >= previous;
+      previous = reading.sample;
+      reads++;
+      std::this_thread::yield();
+    }
+    writer.join();
+
+    // Verify
+    expect(that % consistent);
+    expect(that % monotonic);
+    expect(that % reads > 0);
+    expect(that % total == test_subject.read().sample);
+  };
+};
+}  // namespace embed::cortex_m
@@ -0,0 +1,114 @@
+#include <array>
+#include <thread>
+
+#include <boost/ut.hpp>
+#include <libarmcortex/spsc_queue.hpp>
+
+namespace embed::cortex_m {
+boost::ut::suite spsc_queue_test = []() {
+  using namespace boost::ut;
+
+  should("spsc_queue::push() & spsc_queue::pop()") = []() {
+    // Setup
+    spsc_queue<int, 4> test_subject;
+
+    // Exercise & Verify
+    expect(that % test_subject.empty());
+    expect(!test_subject.pop().has_value());
+    expect(that % test_subject.push(1));
+    expect(that % test_subject.push(2));
+    expect(that % test_subject.push(3));
+    expect(that % test_subject.push(4));
+    expect(that % !test_subject.push(5));
+    expect(that % 4 == test_subject.size());
+    expect(that % 1 == test_subject.pop().value());
+    expect(that % 2 == test_subject.pop().value());
+    expect(that % test_subject.push(5));
+    expect(that % 3 == test_subject.pop().value());
+    expect(that % 4 == test_subject.pop().value());
+    expect(that % 5 == test_subject.pop().value());
+    expect(!test_subject.pop().has_value());
+  };
+
+  should("spsc_queue::push(span) & spsc_queue::pop(span)") = []() {
+    // Setup
+    spsc_queue<int, 8> test_subject;
+    std::array<int, 6> input{ 1, 2, 3, 4, 5, 6 };
+    std::array<int, 8> output{};
+
+    // Exercise & Verify
+    expect(that % 6 == test_subject.push(input));
+    // Verify: only the remaining space is filled
+    expect(that % 2 == test_subject.push(input));
+    expect(that % 8 == test_subject.size());
+
+    expect(that % 8 == test_subject.pop(output));
+    expect(that % 1 == output[0]);
+    expect(that % 6 == output[5]);
+    expect(that % 1 == output[6]);
+    expect(that % 2 == output[7]);
+    expect(that % 0 == test_subject.pop(output));
+
+    // Verify: batches wrap around the end of the buffer
+    expect(that % 6 == test_subject.push(input));
+    expect(that % 3 == test_subject.pop(std::span(output).first(3)));
+    expect(that % 5 == test_subject.push(input));
+    expect(that % 8 == test_subject.pop(output));
+    expect(that % 4 == output[0]);
+    expect(that % 6 == output[2]);
+    expect(that % 1 == output[3]);
+    expect(that % 5 == output[7]);
+  };
+
+  should("spsc_queue stress: thread producer (ISR) & consumer") = []() {
+    // Setup
+    static constexpr std::uint32_t total = 100'000;
+    static spsc_queue<std::uint32_t, 64> test_subject;
+    bool in_order = true;
+
+    // Exercise
+    std::thread producer([]() {
+      std::array<std::uint32_t, 5> batch{};
+      std::uint32_t next = 0;
+      while (next < total) {
+        if (next % 3 == 0) {
+          if (test_subject.push(next)) {
+            next++;
+          } else {
+            std::this_thread::yield();
+          }
+          continue;
+        }
+        for (std::uint32_t i = 0; i < batch.size(); i++) {
+          batch[i] = next + i;
+        }
+        auto remaining = std::min<std::size_t>(batch.size(), total - next);
+        auto pushed = test_subject.push(std::span(batch).first(remaining));
+        if (pushed == 0) {
+          std::this_thread::yield();
+        }
+        next += static_cast<std::uint32_t>(pushed);
+      }
+    });
+
+    std::uint32_t expected = 0;
+    std::array<std::uint32_t, 7> output{};
+    while (expected < total) {
+      auto count = test_subject.pop(output);
+      if (count == 0) {
+        std::this_thread::yield();
+      }
+      for (std::size_t i = 0; i < count; i++) {
+        in_order = in_order && (output[i] == expected);
+        expected++;
+      }
+    }
+    producer.join();
+
+    // Verify
+    expect(that % in_order);
+    expect(that % total == expected);
+    expect(that % test_subject.empty());
+  };
+};
+}  // namespace embed::cortex_m
@@ -0,0 +1,118 @@
+#include <boost/ut.hpp>
+#include <libarmcortex/storm_guard.hpp>
+
+namespace embed::cortex_m {
+namespace {
+int handler_calls = 0;
+
+void counting_handler()
+{
+  handler_calls++;
+}
+}  // namespace
+
+boost::ut::suite storm_guard_test = []() {
+  using namespace boost::ut;
+
+  static constexpr size_t interrupt_count = 42;
+  static constexpr int irq = 9;
+  using guard = storm_guard<irq, 3, 1'000, 5'000>;
+  static constexpr auto handler =
+    interrupt::trampoline<counting_handler, guard>;
+
+  interrupt::reinitialize<interrupt_count>();
+
+  should("storm_guard below the rate") = []() {
+    // Setup
+    dwt_counter::dwt()->cyccnt = 0;
+    guard::reset();
+    interrupt::nvic()->icer.at(0) = 0;
+    handler_calls = 0;
+
+    // Exercise: three interrupts per window over several windows
+    for (std::uint32_t cycle = 0; cycle < 4'000; cycle += 350) {
+      dwt_counter::dwt()->cyccnt = cycle;
+      handler();
+    }
+
+    // Verify
+    expect(that % 12 == handler_calls);
+    expect(that % 0 == guard::storms());
+    expect(that % 3 == guard::peak());
+    expect(that % !guard::throttled());
+    expect(that % 0 == interrupt::nvic()->icer.at(0));
+  };
+
+  should("storm_guard masks and backs off") = []() {
+    // Setup
+    dwt_counter::dwt()->cyccnt = 10'000;
+    guard::reset();
+    interrupt::nvic()->icer.at(0) = 0;
+    interrupt::nvic()->iser.at(0) = 0;
+    handler_calls = 0;
+
+    // Exercise: a stuck flag fires back to back
+    for (int i = 0; i < 4; i++) {
+      dwt_counter::dwt()->cyccnt = dwt_counter::dwt()->cyccnt + 10;
+      handler();
+    }
+    const auto masked = interrupt::nvic()->icer.at(0);
+    dwt_counter::dwt()->cyccnt = 10'040 + 4'999;
+    const bool still_throttled = guard::poll();
+    const auto unmasked_early = interrupt::nvic()->iser.at(0);
+    dwt_counter::dwt()->cyccnt = 10'040 + 5'000;
+    const bool throttled_after_backoff = guard::poll();
+
+    // Verify
+    expect(that % 4 == handler_calls);
+    expect(that % 1 == guard::storms());
+    expect(that % 4 == guard::peak());
+    expect(that % (1U << irq) == masked);
+    expect(that % still_throttled);
+    expect(that % 0 == unmasked_early);
+    expect(that % !throttled_after_backoff);
+    expect(that % !guard::throttled());
+    expect(that % (1U << irq) == interrupt::nvic()->iser.at(0));
+  };
+
+  should("storm_guard::reset() restarts the window") = []() {
+    // Setup: a full window of three interrupts
+    dwt_counter::dwt()->cyccnt = 20'000;
+    guard::reset();
+    interrupt::nvic()->icer.at(0) = 0;
+    handler_calls = 0;
+    for (std::uint32_t cycle = 20'100; cycle <= 20'300; cycle += 100) {
+      dwt_counter::dwt()->cyccnt = cycle;
+      handler();
+    }
+
+    // Exercise: the next interrupt after a reset starts a new window rather
+    // than being the fourth of the old one
+    guard::reset();
+    for (std::uint32_t cycle = 20'450; cycle <= 20'650; cycle += 100) {
+      dwt_counter::dwt()->cyccnt = cycle;
+      handler();
+    }
+
+    // Verify
+    expect(that % 6 == handler_calls);
+    expect(that % 0 == guard::storms());
+    expect(that % 3 == guard::peak());
+    expect(that % !guard::throttled());
+    expect(that % 0 == interrupt::nvic()->icer.at(0));
+  };
+
+  should("storm_guard::poll() when not throttled") = []() {
+    // Setup
+    guard::reset();
+    interrupt::nvic()->iser.at(0) = 0;
+
+    // Exercise
+    const bool throttled = guard::poll();
+
+    // Verify
+    expect(that % !throttled);
+    expect(that % 0 == interrupt::nvic()->iser.at(0));
+  };
+};
+}  // namespace embed::cortex_m
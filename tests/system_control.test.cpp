@@ -0,0 +1,120 @@
+#include <array>
+
+#include <boost/ut.hpp>
+#include <libarmcortex/system_control.hpp>
+
+namespace embed::cortex_m {
+namespace {
+constexpr std::uint32_t cortex_m4_cpuid = 0x410F'C241;
+constexpr std::uint32_t cortex_m7_cpuid = 0x411F'C270;
+
+/// CPUID is read only, so the dummy register is written through a cast
+void set_cpuid(std::uint32_t p_value)
+{
+  *const_cast<volatile std::uint32_t*>(&system_control::scb()->cpuid) =
+    p_value;
+}
+}  // namespace
+
+boost::ut::suite system_control_test = []() {
+  using namespace boost::ut;
+
+  should("system_control::set_core_configuration()") = []() {
+    // Setup
+    system_control test_subject;
+    set_cpuid(cortex_m4_cpuid);
+    system_control::scb()->ccr = 1U << 9U;
+    *system_control::actlr() = 0;
+    system_control::cache()->dcisw = 0xFFFF'FFFF;
+    const system_control::core_configuration expected{
+      .unaligned_trap = true,
+      .divide_by_zero_trap = true,
+      .stack_align = false,
+      .data_cache = true,
+      .instruction_cache = true,
+      .branch_prediction = true,
+      .disable_multicycle_interrupt = false,
+      .disable_write_buffer = true,
+      .disable_it_folding = true,
+    };
+
+    // Exercise
+    const auto initial = test_subject.get_core_configuration();
+    const auto applied = test_subject.set_core_configuration(expected);
+
+    // Verify
+    expect(initial == system_control::core_configuration{});
+    expect(applied == expected);
+    expect(that % 0x0007'0018 == system_control::scb()->ccr);
+    expect(that % 0b110 == *system_control::actlr());
+    // Verify: the data cache was invalidated before it was enabled
+    expect(that % 0 == system_control::cache()->dcisw);
+  };
+
+  should("system_control::set_core_configuration() disables caches") = []() {
+    // Setup
+    system_control test_subject;
+    set_cpuid(cortex_m4_cpuid);
+    system_control::scb()->ccr = (1U << 16U) | (1U << 9U);
+    *system_control::actlr() = 0b111;
+    system_control::cache()->dccisw = 0xFFFF'FFFF;
+    system_control::cache()->dcisw = 0xFFFF'FFFF;
+
+    // Exercise
+    const auto applied =
+      test_subject.set_core_configuration(system_control::core_configuration{});
+
+    // Verify: dirty lines are written back rather than discarded
+    expect(applied == system_control::core_configuration{});
+    expect(that % (1U << 9U) == system_control::scb()->ccr);
+    expect(that % 0 == *system_control::actlr());
+    expect(that % 0 == system_control::cache()->dccisw);
+    expect(that % 0xFFFF'FFFF == system_control::cache()->dcisw);
+  };
+
+  should("system_control::set_core_configuration() leaves M7 ACTLR") = []() {
+    // Setup
+    system_control test_subject;
+    set_cpuid(cortex_m7_cpuid);
+    system_control::scb()->ccr = 1U << 9U;
+    *system_control::actlr() = 0b101;
+    const system_control::core_configuration requested{
+      .branch_prediction = true,
+      .disable_write_buffer = true,
+    };
+
+    // Exercise
+    const auto initial = test_subject.get_core_configuration();
+    const auto applied = test_subject.set_core_configuration(requested);
+
+    // Verify: the M3/M4 ACTLR fields are neither read nor written
+    expect(that % !system_control::has_m3_m4_auxiliary_control());
+    expect(initial == system_control::core_configuration{});
+    expect(that % applied.branch_prediction);
+    expect(that % !applied.disable_write_buffer);
+    expect(that % 0b101 == *system_control::actlr());
+
+    // Cleanup
+    set_cpuid(0);
+  };
+
+  should("system_control::priority_group_mask()") = []() {
+    // Setup
+    std::array<std::uint8_t, 3> masks{};
+
+    // Exercise
+    system_control::scb()->aircr = 0;
+    masks[0] = system_control::priority_group_mask();
+    system_control::scb()->aircr = 5U << 8U;
+    masks[1] = system_control::priority_group_mask();
+    system_control::scb()->aircr = 7U << 8U;
+    masks[2] = system_control::priority_group_mask();
+    system_control::scb()->aircr = 0;
+
+    // Verify: PRIGROUP 7 leaves no group priority bits, nothing preempts
+    expect(that % 0xFE == masks[0]);
+    expect(that % 0xC0 == masks[1]);
+    expect(that % 0x00 == masks[2]);
+  };
+};
+}  // namespace embed::cortex_m
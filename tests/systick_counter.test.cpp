@@ -0,0 +1,145 @@
+#include <boost/ut.hpp>
+#include <libarmcortex/systick_counter.hpp>
+
+namespace embed::cortex_m {
+boost::ut::suite systick_counter_test = []() {
+  using namespace boost::ut;
+  using namespace embed::literals;
+
+  static constexpr size_t interrupt_count = 42;
+  static constexpr auto vector =
+    static_cast<size_t>(interrupt::core_interrupts + systick_timer::irq);
+  static constexpr std::uint32_t pend_systick_set = 1U << 26U;
+
+  interrupt::reinitialize<interrupt_count>();
+
+  should("systick_counter::systick_counter()") = []() {
+    // Setup
+    auto* sys_tick = systick_timer::sys_tick();
+    sys_tick->reload = 1234;
+
+    // Exercise
+    systick_counter test_subject(8_MHz);
+
+    // Verify
+    expect(that % systick_counter::reload == sys_tick->reload);
+    expect(that % 0b111 == sys_tick->control);
+    expect(interrupt::vector_table[vector] != interrupt::nop);
+  };
+
+  should("systick_counter::uptime()") = []() {
+    // Setup
+    systick_counter test_subject(8_MHz);
+    system_control::scb()->icsr = 0;
+
+    // Exercise
+    systick_timer::sys_tick()->current_value = systick_counter::reload;
+    auto start = test_subject.uptime().value();
+    systick_timer::sys_tick()->current_value = systick_counter::reload - 100;
+    auto later = test_subject.uptime().value();
+
+    // Verify
+    expect(8_MHz == start.frequency);
+    expect(that % 0 == start.count);
+    expect(that % 100 == later.count);
+  };
+
+  should("systick_counter::uptime() across wraps") = []() {
+    // Setup
+    systick_counter test_subject(8_MHz);
+    auto* sys_tick = systick_timer::sys_tick();
+    system_control::scb()->icsr = 0;
+
+    // Exercise: the counter wraps and the interrupt is serviced
+    sys_tick->current_value = 1;
+    auto before_wrap = test_subject.uptime().value();
+    sys_tick->current_value = systick_counter::reload - 5;
+    interrupt::vector_table[vector]();
+    auto first_period = test_subject.uptime().value();
+
+    // Exercise: the counter wraps again but the interrupt is held off
+    sys_tick->current_value = systick_counter::reload - 7;
+    system_control::scb()->icsr = pend_systick_set;
+    auto pending = test_subject.uptime().value();
+
+    // Exercise: the held off interrupt is serviced
+    system_control::scb()->icsr = 0;
+    interrupt::vector_table[vector]();
+    auto serviced = test_subject.uptime().value();
+
+    // Verify
+    expect(that % (systick_counter::reload - 1) == before_wrap.count);
+    expect(that % (systick_counter::period + 5) == first_period.count);
+    expect(that % (2 * systick_counter::period + 7) == pending.count);
+    expect(that % pending.count == serviced.count);
+  };
+
+  should("systick_counter::uptime() before the first tick") = []() {
+    // Setup
+    systick_counter test_subject(8_MHz);
+    auto* sys_tick = systick_timer::sys_tick();
+    system_control::scb()->icsr = 0;
+
+    // Exercise: the counter has been cleared but has not loaded yet
+    auto cleared = test_subject.uptime().value();
+    sys_tick->current_value = systick_counter::reload;
+    auto loaded = test_subject.uptime().value();
+    sys_tick->current_value = systick_counter::reload - 1;
+    auto first_tick = test_subject.uptime().value();
+
+    // Verify
+    expect(that % 0 == cleared.count);
+    expect(that % 0 == loaded.count);
+    expect(that % 1 == first_tick.count);
+  };
+
+  should("systick_counter::uptime() is monotonic at a wrap") = []() {
+    // Setup
+    systick_counter test_subject(8_MHz);
+    auto* sys_tick = systick_timer::sys_tick();
+    system_control::scb()->icsr = 0;
+    sys_tick->current_value = systick_counter::reload;
+    interrupt::vector_table[vector]();
+
+    // Exercise: count down through 0, where the wrap is pended, to the reload
+    sys_tick->current_value = 1;
+    auto last_but_one = test_subject.uptime().value();
+    sys_tick->current_value = 0;
+    system_control::scb()->icsr = pend_systick_set;
+    auto zero_pending = test_subject.uptime().value();
+    system_control::scb()->icsr = 0;
+    interrupt::vector_table[vector]();
+    auto zero_serviced = test_subject.uptime().value();
+    sys_tick->current_value = systick_counter::reload;
+    auto reloaded = test_subject.uptime().value();
+
+    // Verify
+    expect(that % (2 * systick_counter::period - 2) == last_but_one.count);
+    expect(that % (2 * systick_counter::period - 1) == zero_pending.count);
+    expect(that % (2 * systick_counter::period - 1) == zero_serviced.count);
+    expect(that % (2 * systick_counter::period) == reloaded.count);
+  };
+
+  should("systick_counter::register_cpu_frequency()") = []() {
+    // Setup
+    systick_counter test_subject(8_MHz);
+
+    // Exercise
+    test_subject.register_cpu_frequency(12_MHz);
+
+    // Verify
+    expect(12_MHz == test_subject.uptime().value().frequency);
+  };
+
+  should("systick_counter::~systick_counter()") = []() {
+    // Setup
+    {
+      systick_counter test_subject(8_MHz);
+    }
+
+    // Verify
+    expect(that % 0 == (systick_timer::sys_tick()->control & 1U));
+    expect(interrupt::vector_table[vector] == interrupt::nop);
+  };
+};
+}  // namespace embed::cortex_m
@@ -1,7 +1,31 @@
+#include <thread>
+
 #include <boost/ut.hpp>
 #include <libarmcortex/systick_timer.hpp>
 
 namespace embed::cortex_m {
+namespace {
+/**
+ * @brief Simulate SysTick loading a re-armed event's remaining time.
+ *
+ * After re-arming, the driver waits for the counter to load the remaining time
+ * from the reload register before switching it to the period. Waits for the
+ * counter to be enabled with p_remaining as its reload value, then loads it.
+ */
+std::thread load_counter(std::uint32_t p_remaining)
+{
+  return std::thread([p_remaining]() {
+    constexpr std::uint32_t enable = 1U << 0U;
+    auto* sys_tick = systick_timer::sys_tick();
+    while ((sys_tick->control & enable) == 0U ||
+           sys_tick->reload != p_remaining || sys_tick->current_value != 0) {
+      std::this_thread::yield();
+    }
+    sys_tick->current_value = p_remaining;
+  });
+}
+}  // namespace
+
 boost::ut::suite systick_timer_test = []() {
   using namespace boost::ut;
   using namespace std::chrono_literals;
@@ -33,6 +57,279 @@ boost::ut::suite systick_timer_test = []() {
     // Verify
   };
 
+  should("systick_timer::instrument() with DWT") = [&] {
+    // Setup
+    static constexpr auto vector =
+      static_cast<size_t>(interrupt::core_interrupts + systick_timer::irq);
+    systick_timer::statistics statistics(8);
+    std::uint32_t duration = 20;
+    auto callback = [&duration]() {
+      dwt_counter::dwt()->cyccnt = dwt_counter::dwt()->cyccnt + duration;
+    };
+    dwt_counter::dwt()->ctrl = dwt_counter::enable_cycle_count;
+    dwt_counter::dwt()->cyccnt = 1'000;
+    test_subject.instrument(&statistics);
+
+    // Exercise: with a 1MHz clock, 100us is a reload of 100, so the timer
+    // expires every 101 cycles starting at 1101.
+    const bool scheduled =
+      static_cast<bool>(test_subject.schedule(callback, 100us));
+    dwt_counter::dwt()->cyccnt = 1'105;
+    interrupt::vector_table[vector]();
+    duration = 60;
+    dwt_counter::dwt()->cyccnt = 1'250;
+    interrupt::vector_table[vector]();
+    duration = 5;
+    dwt_counter::dwt()->cyccnt = 1'510;
+    interrupt::vector_table[vector]();
+    test_subject.instrument(nullptr);
+    dwt_counter::dwt()->cyccnt = 1'700;
+    interrupt::vector_table[vector]();
+    dwt_counter::dwt()->ctrl = 0;
+
+    // Verify: the second run finishes past the next expiry and the third
+    // interrupt is held off past two whole expiries. The fourth run happens
+    // after instrumentation was disabled and is not recorded.
+    const auto last = statistics.last.read();
+    expect(that % scheduled);
+    expect(that % 3 == statistics.lateness.total());
+    expect(that % 48 == statistics.lateness.max());
+    expect(that % 60 == statistics.duration.max());
+    expect(that % 3 == statistics.deadline_misses.load());
+    expect(that % 1'505 == last.expiry);
+    expect(that % 1'510 == last.entry);
+    expect(that % 5 == last.duration);
+  };
+
+  should("systick_timer::instrument() before expiry") = [&] {
+    // Setup
+    static constexpr auto vector =
+      static_cast<size_t>(interrupt::core_interrupts + systick_timer::irq);
+    systick_timer::statistics statistics(8);
+    auto callback = []() {
+      dwt_counter::dwt()->cyccnt = dwt_counter::dwt()->cyccnt + 20;
+    };
+    dwt_counter::dwt()->ctrl = dwt_counter::enable_cycle_count;
+    dwt_counter::dwt()->cyccnt = 1'000;
+    test_subject.instrument(&statistics);
+
+    // Exercise: expiries are at 1101 and 1202, both interrupts arrive a few
+    // cycles early
+    const bool scheduled =
+      static_cast<bool>(test_subject.schedule(callback, 100us));
+    dwt_counter::dwt()->cyccnt = 1'095;
+    interrupt::vector_table[vector]();
+    dwt_counter::dwt()->cyccnt = 1'200;
+    interrupt::vector_table[vector]();
+    test_subject.instrument(nullptr);
+    dwt_counter::dwt()->ctrl = 0;
+
+    // Verify: early is on time, not ~2^32 cycles late
+    const auto last = statistics.last.read();
+    expect(that % scheduled);
+    expect(that % 2 == statistics.lateness.total());
+    expect(that % 0 == statistics.lateness.max());
+    expect(that % 0 == statistics.deadline_misses.load());
+    expect(that % 1'202 == last.expiry);
+    expect(that % 1'200 == last.entry);
+  };
+
+  should("systick_timer::instrument() across a frequency change") = [&] {
+    // Setup
+    static constexpr auto vector =
+      static_cast<size_t>(interrupt::core_interrupts + systick_timer::irq);
+    auto* sys_tick = systick_timer::sys_tick();
+    systick_timer::statistics statistics(8);
+    dwt_counter::dwt()->ctrl = dwt_counter::enable_cycle_count;
+    dwt_counter::dwt()->cyccnt = 1'000;
+    test_subject.instrument(&statistics);
+    // 1ms at 1MHz expires every 1001 cycles, starting at 2001
+    const bool scheduled =
+      static_cast<bool>(test_subject.schedule([]() {}, 1ms));
+    dwt_counter::dwt()->cyccnt = 2'001;
+    interrupt::vector_table[vector]();
+
+    // Exercise: halve the frequency with 500 ticks left, leaving 250 ticks
+    // at 500kHz and then a period of 501 cycles
+    dwt_counter::dwt()->cyccnt = 2'500;
+    sys_tick->current_value = 500;
+    auto load = load_counter(250);
+    const bool halved = static_cast<bool>(
+      test_subject.register_cpu_frequency(500_kHz));
+    load.join();
+    dwt_counter::dwt()->cyccnt = 2'752;
+    interrupt::vector_table[vector]();
+    dwt_counter::dwt()->cyccnt = 3'253;
+    interrupt::vector_table[vector]();
+    test_subject.instrument(nullptr);
+    dwt_counter::dwt()->ctrl = 0;
+    const bool cleared = static_cast<bool>(test_subject.clear());
+    const bool restored = static_cast<bool>(
+      test_subject.register_cpu_frequency(1_MHz));
+
+    // Verify: both runs after the change are 2 cycles after the new expiries
+    const auto last = statistics.last.read();
+    expect(that % scheduled);
+    expect(that % halved);
+    expect(that % cleared);
+    expect(that % restored);
+    expect(that % 3 == statistics.lateness.total());
+    expect(that % 2 == statistics.lateness.max());
+    expect(that % 0 == statistics.deadline_misses.load());
+    expect(that % 3'251 == last.expiry);
+    expect(that % 3'253 == last.entry);
+  };
+
+  should("systick_timer::instrument() without DWT") = [&] {
+    // Setup
+    static constexpr auto vector =
+      static_cast<size_t>(interrupt::core_interrupts + systick_timer::irq);
+    systick_timer::statistics statistics(8);
+    auto callback = []() { systick_timer::sys_tick()->current_value = 70; };
+    dwt_counter::dwt()->ctrl = 0;
+    test_subject.instrument(&statistics);
+
+    // Exercise
+    const bool scheduled =
+      static_cast<bool>(test_subject.schedule(callback, 100us));
+    systick_timer::sys_tick()->current_value = 90;
+    interrupt::vector_table[vector]();
+    test_subject.instrument(nullptr);
+
+    // Verify
+    const auto last = statistics.last.read();
+    expect(that % scheduled);
+    expect(that % 10 == statistics.lateness.max());
+    expect(that % 20 == statistics.duration.max());
+    expect(that % 10 == last.entry);
+    expect(that % 0 == statistics.deadline_misses.load());
+  };
+
+  should("systick_timer::register_cpu_frequency() preserves deadline") = [&] {
+    // Setup
+    static constexpr auto vector =
+      static_cast<size_t>(interrupt::core_interrupts + systick_timer::irq);
+    auto* sys_tick = systick_timer::sys_tick();
+    int calls = 0;
+    const bool scheduled =
+      static_cast<bool>(test_subject.schedule([&calls]() { calls++; }, 1ms));
+    // 400us left of the 1ms delay at 1MHz
+    sys_tick->current_value = 400;
+
+    // Exercise
+    auto load = load_counter(800);
+    const bool doubled = static_cast<bool>(
+      test_subject.register_cpu_frequency(2_MHz));
+    load.join();
+    const std::uint32_t doubled_remaining = sys_tick->current_value;
+    const std::uint32_t doubled_reload = sys_tick->reload;
+    // 300us left at 2MHz
+    sys_tick->current_value = 600;
+    load = load_counter(150);
+    const bool halved = static_cast<bool>(
+      test_subject.register_cpu_frequency(500_kHz));
+    load.join();
+    const std::uint32_t halved_remaining = sys_tick->current_value;
+    const std::uint32_t halved_reload = sys_tick->reload;
+    load = load_counter(300);
+    const bool restored = static_cast<bool>(
+      test_subject.register_cpu_frequency(1_MHz));
+    load.join();
+    interrupt::vector_table[vector]();
+
+    // Verify
+    expect(that % scheduled);
+    expect(that % doubled);
+    expect(that % halved);
+    expect(that % restored);
+    expect(that % 800 == doubled_remaining);
+    expect(that % 2'000 == doubled_reload);
+    expect(that % 150 == halved_remaining);
+    expect(that % 500 == halved_reload);
+    expect(that % 300 == sys_tick->current_value);
+    expect(that % 1'000 == sys_tick->reload);
+    expect(that % 1 == calls);
+    expect(that % test_subject.is_running().value());
+  };
+
+  should("systick_timer::register_cpu_frequency() near expiry") = [&] {
+    // Setup
+    auto* sys_tick = systick_timer::sys_tick();
+    const bool scheduled =
+      static_cast<bool>(test_subject.schedule([]() {}, 1ms));
+
+    // Exercise: 3us left rounds up to the minimum
+    sys_tick->current_value = 3;
+    auto load = load_counter(systick_timer::rearm_minimum);
+    const bool doubled = static_cast<bool>(
+      test_subject.register_cpu_frequency(2_MHz));
+    load.join();
+    const std::uint32_t minimum = sys_tick->current_value;
+    // Just expired, so a whole period is left
+    sys_tick->current_value = 0;
+    load = load_counter(1'000);
+    const bool restored = static_cast<bool>(
+      test_subject.register_cpu_frequency(1_MHz));
+    load.join();
+
+    // Verify
+    expect(that % scheduled);
+    expect(that % doubled);
+    expect(that % restored);
+    expect(that % systick_timer::rearm_minimum == minimum);
+    expect(that % 1'000 == sys_tick->current_value);
+    expect(that % 1'000 == sys_tick->reload);
+  };
+
+  should("systick_timer::register_cpu_frequency() while stopped") = [&] {
+    // Setup
+    auto* sys_tick = systick_timer::sys_tick();
+    const bool scheduled =
+      static_cast<bool>(test_subject.schedule([]() {}, 1ms));
+    const bool cleared = static_cast<bool>(test_subject.clear());
+    sys_tick->current_value = 400;
+
+    // Exercise
+    const bool doubled = static_cast<bool>(
+      test_subject.register_cpu_frequency(2_MHz));
+    const bool running = test_subject.is_running().value();
+    const bool restored = static_cast<bool>(
+      test_subject.register_cpu_frequency(1_MHz));
+
+    // Verify
+    expect(that % scheduled);
+    expect(that % cleared);
+    expect(that % doubled);
+    expect(that % restored);
+    expect(that % !running);
+    expect(that % 0 == sys_tick->current_value);
+  };
+
+  should("systick_timer::register_cpu_frequency() period out of range") = [&] {
+    // Setup: 1s is 10'000'000 ticks at 10MHz but 48'000'000 at 48MHz, which
+    // is more than the 24-bit counter holds
+    auto* sys_tick = systick_timer::sys_tick();
+    const bool slowed = static_cast<bool>(
+      test_subject.register_cpu_frequency(10_MHz));
+    const bool scheduled =
+      static_cast<bool>(test_subject.schedule([]() {}, 1s));
+    sys_tick->current_value = 5'000'000;
+
+    // Exercise
+    const bool sped_up = static_cast<bool>(
+      test_subject.register_cpu_frequency(48_MHz));
+    const bool running = test_subject.is_running().value();
+    const bool restored = static_cast<bool>(
+      test_subject.register_cpu_frequency(1_MHz));
+
+    // Verify
+    expect(that % slowed);
+    expect(that % scheduled);
+    expect(that % !sped_up);
+    expect(that % !running);
+    expect(that % restored);
+  };
+
   should("systick_timer::~systick_timer()") = [&] {
     // Setup
     // Exercise
@@ -0,0 +1,119 @@
+#include <array>
+#include <string>
+
+#include <boost/ut.hpp>
+#include <libarmcortex/interrupt.hpp>
+#include <libarmcortex/trace.hpp>
+#include <libarmcortex/trace_export.hpp>
+
+namespace embed::cortex_m {
+boost::ut::suite trace_test = []() {
+  using namespace boost::ut;
+  using namespace embed::literals;
+
+  should("basic_trace::record() & basic_trace::snapshot()") = []() {
+    // Setup
+    using test_trace = basic_trace<true, 8>;
+    std::array<trace_event, 8> events{};
+    test_trace::clear();
+
+    // Exercise
+    dwt_counter::dwt()->cyccnt = 10;
+    test_trace::enter(5);
+    dwt_counter::dwt()->cyccnt = 20;
+    test_trace::marker(42);
+    dwt_counter::dwt()->cyccnt = 30;
+    test_trace::exit(5);
+    const auto count = test_trace::snapshot(events);
+
+    // Verify
+    expect(that % 3 == count);
+    expect(that % 10 == events[0].cycle_count);
+    expect(trace_event_type::irq_enter == events[0].type);
+    expect(that % 5 == events[0].id);
+    expect(trace_event_type::marker == events[1].type);
+    expect(that % 42 == events[1].id);
+    expect(that % 30 == events[2].cycle_count);
+    expect(trace_event_type::irq_exit == events[2].type);
+  };
+
+  should("basic_trace::snapshot() after wrap around") = []() {
+    // Setup
+    using test_trace = basic_trace<true, 4>;
+    std::array<trace_event, 4> events{};
+    test_trace::clear();
+
+    // Exercise
+    for (int i = 0; i < 10; i++) {
+      test_trace::marker(i);
+    }
+    const auto count = test_trace::snapshot(events);
+
+    // Verify: only the most recent events remain, oldest first
+    expect(that % 4 == count);
+    expect(that % 6 == events[0].id);
+    expect(that % 7 == events[1].id);
+    expect(that % 8 == events[2].id);
+    expect(that % 9 == events[3].id);
+  };
+
+  should("basic_trace disabled") = []() {
+    // Setup
+    using test_trace = basic_trace<false, 4>;
+    std::array<trace_event, 4> events{};
+
+    // Exercise
+    test_trace::marker(1);
+
+    // Verify
+    expect(that % 0 == test_trace::snapshot(events));
+  };
+
+  should("basic_trace as interrupt::trampoline hook") = []() {
+    // Setup
+    using test_trace = basic_trace<true, 8>;
+    std::array<trace_event, 8> events{};
+    test_trace::clear();
+    system_control::scb()->icsr =
+      static_cast<uint32_t>(3 + interrupt::core_interrupts);
+
+    // Exercise
+    interrupt::trampoline<interrupt::nop, test_trace>();
+    system_control::scb()->icsr = 0;
+    const auto count = test_trace::snapshot(events);
+
+    // Verify
+    expect(that % 2 == count);
+    expect(trace_event_type::irq_enter == events[0].type);
+    expect(trace_event_type::irq_exit == events[1].type);
+    expect(that % 3 == events[0].id);
+    expect(that % 3 == events[1].id);
+  };
+
+  should("to_chrome_trace_json()") = []() {
+    // Setup
+    const std::array<trace_event, 4> events{
+      trace_event{ 0xFFFF'FF00, trace_event_type::irq_enter, 5 },
+      trace_event{ 0xFFFF'FFF0, trace_event_type::marker, 1 },
+      trace_event{ 0x0000'0100, trace_event_type::irq_exit, 5 },
+      trace_event{ 0x0000'0200, trace_event_type::callback_begin, -1 },
+    };
+
+    // Exercise
+    const auto json = to_chrome_trace_json(events, 256_Hz);
+
+    // Verify
+    expect(
+      json ==
+      "{\"traceEvents\":["
+      "{\"name\":\"IRQ 5\",\"ph\":\"B\",\"ts\":0.000,\"pid\":0,"
+      "\"tid\":\"interrupts\"},"
+      "{\"name\":\"marker 1\",\"ph\":\"i\",\"ts\":937500.000,\"pid\":0,"
+      "\"tid\":\"markers\",\"s\":\"t\"},"
+      "{\"name\":\"IRQ 5\",\"ph\":\"E\",\"ts\":2000000.000,\"pid\":0,"
+      "\"tid\":\"interrupts\"},"
+      "{\"name\":\"callback -1\",\"ph\":\"B\",\"ts\":3000000.000,\"pid\":0,"
+      "\"tid\":\"callbacks\"}]}");
+  };
+};
+}  // namespace embed::cortex_m
@@ -0,0 +1,84 @@
+#include <array>
+#include <atomic>
+#include <thread>
+
+#include <boost/ut.hpp>
+#include <libarmcortex/triple_buffer.hpp>
+
+namespace embed::cortex_m {
+boost::ut::suite triple_buffer_test = []() {
+  using namespace boost::ut;
+
+  using frame_t = std::array<std::uint32_t, 64>;
+
+  should("triple_buffer::publish() & triple_buffer::update()") = []() {
+    // Setup
+    triple_buffer<frame_t> test_subject;
+
+    // Exercise & Verify
+    expect(that % !test_subject.update());
+
+    test_subject.write_buffer().fill(1);
+    test_subject.publish();
+    expect(that % test_subject.update());
+    expect(that % 1 == test_subject.read_buffer()[0]);
+    // Verify: no new frame, the reader keeps its frame
+    expect(that % !test_subject.update());
+    expect(that % 1 == test_subject.read_buffer()[63]);
+
+    // Verify: only the latest frame is delivered
+    test_subject.write_buffer().fill(2);
+    test_subject.publish();
+    test_subject.write_buffer().fill(3);
+    test_subject.publish();
+    expect(that % test_subject.update());
+    expect(that % 3 == test_subject.read_buffer()[0]);
+
+    // Verify: the buffers never alias
+    const auto* reader = &test_subject.read_buffer();
+    expect(that % reader != &test_subject.write_buffer());
+  };
+
+  should("triple_buffer stress: thread writer (ISR) & reader") = []() {
+    // Setup
+    static constexpr std::uint32_t total = 20'000;
+    static triple_buffer<frame_t> test_subject;
+    static std::atomic<bool> done = false;
+    bool consistent = true;
+    bool monotonic = true;
+
+    // Exercise
+    std::thread writer([]() {
+      for (std::uint32_t i = 1; i <= total; i++) {
+        test_subject.write_buffer().fill(i);
+        test_subject.publish();
+        if (i % 16 == 0) {
+          std::this_thread::yield();
+        }
+      }
+      done = true;
+    });
+
+    std::uint32_t previous = 0;
+    while (!done) {
+      if (test_subject.update()) {
+        const auto& frame = test_subject.read_buffer();
+        for (auto value : frame) {
+          consistent = consistent && value == frame[0];
+        }
+        monotonic = monotonic && frame[0] > previous;
+        previous = frame[0];
+      }
+      std::this_thread::yield();
+    }
+    writer.join();
+
+    // Verify
+    expect(that % consistent);
+    expect(that % monotonic);
+    // Verify: the final frame is delivered whether or not it was already seen
+    (void)test_subject.update();
+    expect(that % total == test_subject.read_buffer()[0]);
+  };
+};
+}  // namespace embed::cortex_m